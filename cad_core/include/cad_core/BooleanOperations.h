@@ -1,10 +1,24 @@
 #pragma once
 
 #include "cad_core/Shape.h"
+#include "cad_core/BooleanResultCache.h"
+#include "cad_core/ShapeValidator.h"
+#include <TopTools_ListOfShape.hxx>
+#include <functional>
 #include <vector>
 
+class BRepAlgoAPI_BooleanOperation;
+
 namespace cad_core {
 
+// 简化前后的拓扑规模，用于衡量简化的收益
+struct SimplifyStatistics {
+    int facesBefore = 0;
+    int edgesBefore = 0;
+    int facesAfter = 0;
+    int edgesAfter = 0;
+};
+
 class BooleanOperations {
 public:
     // 布尔运算类型
@@ -22,6 +36,7 @@ public:
     static ShapePtr Intersection(const std::vector<ShapePtr>& shapes);
     
     static ShapePtr Difference(const ShapePtr& shape1, const ShapePtr& shape2);
+    static ShapePtr Difference(const ShapePtr& target, const std::vector<ShapePtr>& tools);
     
     // 通用布尔运算
     static ShapePtr BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type);
@@ -33,8 +48,34 @@ public:
     // 修复形状
     static ShapePtr FixShape(const ShapePtr& shape);
     
-    // 简化形状
-    static ShapePtr SimplifyShape(const ShapePtr& shape);
+    // 简化形状：合并同一曲面上的面和同一曲线上的边，可选去除小特征
+    // history非空时，把合并产生的修改并入该历史
+    static ShapePtr SimplifyShape(const ShapePtr& shape, SimplifyStatistics* statistics = nullptr,
+                                  const Handle(BRepTools_History)& history = Handle(BRepTools_History)());
+    
+    // 每次布尔运算后自动简化结果（默认开启）
+    static void SetSimplifyResults(bool enabled);
+    static bool IsSimplifyResultsEnabled();
+    // 小特征尺寸阈值，小于该值的边和面在简化时去除，0表示不去除
+    static void SetSmallFeatureTolerance(double tolerance);
+    static double GetSmallFeatureTolerance();
+    // 最近一次布尔运算的简化统计，缓存命中或未实际运算时全为0
+    static const SimplifyStatistics& GetLastSimplifyStatistics();
+    
+    // 运算参数：并行模式与模糊容差（作用于所有布尔运算）
+    static void SetRunParallel(bool enabled);
+    static bool GetRunParallel();
+    static void SetFuzzyValue(double value);
+    static double GetFuzzyValue();
+    
+    // 结果验证策略（默认Full）
+    static void SetValidationPolicy(ValidationPolicy policy);
+    static ValidationPolicy GetValidationPolicy();
+    
+    // 结果缓存：撤销后重做同一运算、预览重复计算时直接复用
+    static void SetResultCacheEnabled(bool enabled);
+    static bool IsResultCacheEnabled();
+    static BooleanResultCache& GetResultCache();
     
 private:
     // 私有辅助方法
@@ -42,9 +83,34 @@ private:
     static ShapePtr PerformIntersection(const ShapePtr& shape1, const ShapePtr& shape2);
     static ShapePtr PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2);
     
+    // 多参数运算：所有参数一次性交给同一个General Fuse构建器
+    static ShapePtr PerformMultiUnion(const std::vector<ShapePtr>& shapes);
+    static ShapePtr PerformMultiIntersection(const std::vector<ShapePtr>& shapes);
+    static ShapePtr PerformMultiDifference(const ShapePtr& target, const std::vector<ShapePtr>& tools);
+    static ShapePtr RunOperation(BRepAlgoAPI_BooleanOperation& operation,
+                                 const TopTools_ListOfShape& arguments,
+                                 const TopTools_ListOfShape& tools);
+    
+    static ShapePtr CachedOperation(BooleanType type, const std::vector<ShapePtr>& operands,
+                                    const std::function<ShapePtr()>& operation);
+    
+    // 包围盒粗筛：先比较缓存的AABB，重叠时再比较OBB
+    static bool BoundingBoxesOverlap(const ShapePtr& shape1, const ShapePtr& shape2);
+    static ShapePtr MakeCompound(const std::vector<ShapePtr>& shapes);
+    
     // 形状验证和修复
     static bool ValidateInputs(const ShapePtr& shape1, const ShapePtr& shape2);
-    static ShapePtr PostProcessResult(const TopoDS_Shape& result);
+    static ShapePtr PostProcessResult(const TopoDS_Shape& result, const TopTools_ListOfShape& arguments,
+                                      const Handle(BRepTools_History)& history);
+    
+    static bool s_runParallel;
+    static double s_fuzzyValue;
+    static ValidationPolicy s_validationPolicy;
+    static bool s_resultCacheEnabled;
+    static BooleanResultCache s_resultCache;
+    static bool s_simplifyResults;
+    static double s_smallFeatureTolerance;
+    static SimplifyStatistics s_lastSimplifyStatistics;
 };
 
 } // namespace cad_core
\ No newline at end of file
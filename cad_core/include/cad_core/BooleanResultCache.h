@@ -0,0 +1,71 @@
+#pragma once
+
+#include "cad_core/Shape.h"
+#include <TopoDS_Shape.hxx>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cad_core {
+
+// 布尔运算结果的LRU缓存
+// 键为(运算类型, 操作数的TShape+Location+朝向, 模糊容差)，
+// 条目持有操作数的引用，所以TShape地址不会在缓存有效期内被复用
+class BooleanResultCache {
+public:
+    struct Statistics {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t entryCount = 0;
+        size_t memoryUsage = 0;   // 估算值（字节）
+        size_t memoryBudget = 0;
+    };
+    
+    explicit BooleanResultCache(size_t memoryBudget = 256 * 1024 * 1024);
+    ~BooleanResultCache() = default;
+    
+    // 查找/插入，operationType即BooleanOperations::BooleanType的整数值
+    ShapePtr Find(int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue);
+    void Insert(int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue, const ShapePtr& result);
+    
+    // 清空缓存（关闭文档时调用）
+    void Clear();
+    
+    // 内存预算
+    void SetMemoryBudget(size_t bytes);
+    size_t GetMemoryBudget() const;
+    
+    // 命中统计
+    Statistics GetStatistics() const;
+    void ResetStatistics();
+    
+private:
+    struct Entry {
+        int operationType;
+        std::vector<TopoDS_Shape> operands;
+        double fuzzyValue;
+        ShapePtr result;
+        size_t hash;
+        size_t size;
+    };
+    using EntryList = std::list<Entry>;
+    
+    EntryList m_entries; // 最近使用的在前
+    std::unordered_multimap<size_t, EntryList::iterator> m_index;
+    size_t m_memoryBudget;
+    size_t m_memoryUsage;
+    size_t m_hits;
+    size_t m_misses;
+    size_t m_evictions;
+    mutable std::mutex m_mutex;
+    
+    // 辅助方法
+    static size_t ComputeHash(int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue);
+    static bool Matches(const Entry& entry, int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue);
+    static size_t EstimateSize(const TopoDS_Shape& shape);
+    void EvictToBudget();
+};
+
+} // namespace cad_core
\ No newline at end of file
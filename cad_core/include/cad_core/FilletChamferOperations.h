@@ -1,12 +1,38 @@
 #pragma once
 
 #include "cad_core/Shape.h"
+#include "cad_core/ShapeValidator.h"
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Face.hxx>
+#include <map>
+#include <string>
 #include <vector>
 
+class BRepBuilderAPI_MakeShape;
+
 namespace cad_core {
 
+// 多实体圆角/倒角中单个实体的结果
+struct FilletChamferBodyResult {
+    ShapePtr original;       // 原始实体
+    ShapePtr result;         // 结果，失败时为空
+    size_t edgeCount = 0;    // 该实体上选中的边数
+    std::vector<TopoDS_Edge> rejectedEdges; // 故障隔离模式下被剔除的边
+    std::string error;       // 失败原因
+    
+    bool Succeeded() const { return result != nullptr; }
+};
+
+// 故障隔离圆角的结果：应用了尽可能多的边，其余边单独列出
+struct FilletBatchResult {
+    ShapePtr result;                        // 应用appliedEdges后的形状，一条都没成功时为空
+    std::vector<TopoDS_Edge> appliedEdges;  // 成功倒圆的边
+    std::vector<TopoDS_Edge> rejectedEdges; // 无法倒圆的边
+    int buildCount = 0;                     // 构建器执行次数
+};
+
+using EdgesByShape = std::map<ShapePtr, std::vector<TopoDS_Edge>>;
+
 class FilletChamferOperations {
 public:
     // 圆角操作
@@ -14,9 +40,18 @@ public:
     static ShapePtr CreateFillet(const ShapePtr& shape, const TopoDS_Edge& edge, double radius);
     static ShapePtr CreateVariableFillet(const ShapePtr& shape, const TopoDS_Edge& edge, double radius1, double radius2);
     
+    // 多实体圆角：每个实体一个构建器，在线程池中并行执行
+    static std::vector<FilletChamferBodyResult> CreateFillet(const EdgesByShape& edgesByShape, double radius,
+                                                             bool isolateFailures = false);
+    
+    // 故障隔离圆角：根据构建器报告的故障轮廓和二分法剔除失败的边，
+    // 一次应用最大的可行子集
+    static FilletBatchResult CreateFilletIsolatingFailures(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius);
+    
     // 倒角操作
     static ShapePtr CreateChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance);
     static ShapePtr CreateChamfer(const ShapePtr& shape, const TopoDS_Edge& edge, double distance);
+    static std::vector<FilletChamferBodyResult> CreateChamfer(const EdgesByShape& edgesByShape, double distance);
     static ShapePtr CreateAsymmetricChamfer(const ShapePtr& shape, const TopoDS_Edge& edge, double distance1, double distance2);
     static ShapePtr CreateChamferByAngle(const ShapePtr& shape, const TopoDS_Edge& edge, double distance, double angle);
     
@@ -38,16 +73,29 @@ public:
     static double GetSuggestedFilletRadius(const ShapePtr& shape, const TopoDS_Edge& edge);
     static double GetSuggestedChamferDistance(const ShapePtr& shape, const TopoDS_Edge& edge);
     
+    // 结果验证策略（默认Full）
+    static void SetValidationPolicy(ValidationPolicy policy);
+    static ValidationPolicy GetValidationPolicy();
+    
 private:
     // 私有辅助方法
     static ShapePtr PerformFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius);
     static ShapePtr PerformChamfer(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double distance);
-    static ShapePtr PostProcessResult(const TopoDS_Shape& result);
+    static std::vector<FilletChamferBodyResult> PerformBatch(const EdgesByShape& edgesByShape, double value,
+                                                             bool isFillet, bool isolateFailures);
+    static ShapePtr TryBuildFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                   std::vector<TopoDS_Edge>* faultyEdges);
+    static void BisectFilletEdges(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                  FilletBatchResult& batch);
+    static ShapePtr PostProcessResult(const TopoDS_Shape& result, const ShapePtr& original,
+                                      BRepBuilderAPI_MakeShape& builder);
     
     // 边分析
     static bool AnalyzeEdge(const ShapePtr& shape, const TopoDS_Edge& edge, double& minRadius, double& maxRadius);
     static double GetEdgeLength(const TopoDS_Edge& edge);
     static double GetMinimumRadius(const ShapePtr& shape, const TopoDS_Edge& edge);
+    
+    static ValidationPolicy s_validationPolicy;
 };
 
 } // namespace cad_core
\ No newline at end of file
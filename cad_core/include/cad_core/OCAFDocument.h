@@ -3,6 +3,8 @@
 #include <TDocStd_Document.hxx>
 #include <TDocStd_Application.hxx>
 #include <TDF_Label.hxx>
+#include <TDF_Delta.hxx>
+#include <TDF_LabelMap.hxx>
 #include <TDataStd_TreeNode.hxx>
 #include <TDataStd_Name.hxx>
 #include <TNaming_NamedShape.hxx>
@@ -12,12 +14,30 @@
 #include <TCollection_AsciiString.hxx>
 #include <XCAFDoc_ShapeTool.hxx>
 #include <XCAFDoc_DocumentTool.hxx>
+#include <TopoDS_Shape.hxx>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "cad_core/Shape.h"
 
 namespace cad_core {
 
+// 文档压缩的统计：回收的标签数和估算释放的字节数
+struct CompactionStatistics {
+    int reclaimedLabels = 0;
+    size_t reclaimedBytes = 0;  // 估算值
+    int pendingLabels = 0;      // 已删除但仍在撤销范围内、暂不能回收的标签
+};
+
+// 撤销/重做中发生变化的形状标签
+struct ShapeLabelChange {
+    TDF_Label label;
+    TopoDS_Shape oldShape;  // 变化前的形状，为空表示新增
+    TopoDS_Shape newShape;  // 变化后的形状，为空表示删除
+};
+
 class OCAFDocument {
 public:
     OCAFDocument();
@@ -37,6 +57,19 @@ public:
     ShapePtr GetShape(const TDF_Label& label) const;
     std::vector<TDF_Label> GetAllShapes() const;
     
+    // 索引查找：只包含未删除的形状标签，找不到返回空标签
+    // 多个标签持有同一形状时（如布尔快速路径/缓存命中返回操作数本身），按形状查找返回
+    // 最早的那个，且不会返回当前事务中刚添加的标签
+    TDF_Label FindLabelByName(const std::string& name) const;
+    TDF_Label FindLabelByShape(const TopoDS_Shape& shape) const;
+    
+    // 压缩：清除撤销范围之外已删除形状标签上的所有属性
+    // 事务进行中不执行；默认在保存前自动执行
+    CompactionStatistics CompactDocument();
+    void SetCompactOnSave(bool enabled) { m_compactOnSave = enabled; }
+    bool IsCompactOnSave() const { return m_compactOnSave; }
+    const CompactionStatistics& GetLastCompactionStatistics() const { return m_lastCompaction; }
+    
     // 树操作
     TDF_Label CreateFolder(const std::string& name, const TDF_Label& parent = TDF_Label());
     bool MoveShape(const TDF_Label& shape, const TDF_Label& newParent);
@@ -54,6 +87,8 @@ public:
     bool Redo();
     bool CanUndo() const;
     bool CanRedo() const;
+    // 最近一次撤销/重做改变的形状，由撤销栈中的TDF_Delta得出，界面据此做增量更新
+    const std::vector<ShapeLabelChange>& GetLastChanges() const { return m_lastChanges; }
     void StartTransaction(const std::string& name = "Operation");
     void CommitTransaction();
     void AbortTransaction();
@@ -73,11 +108,42 @@ private:
     
     bool m_isInitialized;
     bool m_inTransaction;
+    bool m_compactOnSave;
+    CompactionStatistics m_lastCompaction;
+    
+    // 已提交且未被撤销的事务序号，以及每个形状标签被删除时所在的事务序号，
+    // 用来判断删除是否已超出撤销范围
+    int m_transactionSerial;
+    std::unordered_map<int, int> m_deathSerials;
+    
+    std::vector<ShapeLabelChange> m_lastChanges;
+    
+    // 当前事务中添加的形状标签，按形状查找时跳过
+    TDF_LabelMap m_transactionLabels;
     
     // 辅助方法
     void InitializeApplication();
     void InitializeDocument();
     TDF_Label GetNextAvailableLabel(const TDF_Label& parent);
+    
+    // 名称→标签、形状→标签索引的维护
+    // 撤销/重做/回滚后数据框架整体变化，直接重建
+    void RebuildIndex();
+    void IndexLabel(const TDF_Label& label);
+    void UnindexLabel(const TDF_Label& label);
+    bool IsLiveShapeLabel(const TDF_Label& label) const;
+    bool IsDeadShapeLabel(const TDF_Label& label) const;
+    TopoDS_Shape GetLiveShape(const TDF_Label& label) const;
+    
+    // 撤销/重做前按增量收集受影响的形状标签并移出索引，之后重新索引并记录变化
+    std::vector<ShapeLabelChange> BeginDeltaChanges(const Handle(TDF_Delta)& delta);
+    void EndDeltaChanges(std::vector<ShapeLabelChange>& changes);
+    static size_t EstimateLabelSize(const TDF_Label& label);
+    
+    // 形状索引的键统一为FORWARD朝向，等价于IsSame比较（同一TShape且同一Location）；
+    // 同一形状可能被多个标签持有，所以一个键对应一组标签
+    std::unordered_map<std::string, TDF_Label> m_nameIndex;
+    std::unordered_map<TopoDS_Shape, std::vector<TDF_Label>> m_shapeIndex;
 };
 
 } // namespace cad_core
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "cad_core/Shape.h"
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace cad_core {
@@ -30,6 +31,9 @@ public:
     std::vector<std::string> GetAllShapeNames() const;
     std::vector<ShapePtr> GetAllShapes() const;
     
+    // 文档压缩：回收撤销范围之外已删除形状的标签
+    CompactionStatistics CompactDocument();
+    
     // 撤销/重做操作
     bool Undo();
     bool Redo();
@@ -48,6 +52,9 @@ private:
     std::shared_ptr<OCAFDocument> m_document;
     bool m_isInitialized;
     
+    // 每个基础名称上次生成的编号
+    mutable std::unordered_map<std::string, int> m_nameCounters;
+    
     // 辅助方法
     TDF_Label FindShapeByName(const std::string& name) const;
     std::string GenerateUniqueName(const std::string& baseName) const;
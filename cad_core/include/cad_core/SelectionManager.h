@@ -11,6 +11,7 @@
 #include <TopAbs_ShapeEnum.hxx>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 #include "cad_core/Shape.h"
 
@@ -34,6 +35,15 @@ struct SelectionInfo {
         : shape(s), subShape(sub), shapeType(type), index(idx) {}
 };
 
+// 单个形状已计算的选择结构占用（各模式的敏感实体和BVH）
+struct SelectionMemoryInfo {
+    ShapePtr shape;
+    std::vector<int> computedModes;
+    size_t entityCount = 0;
+    size_t subElementCount = 0;
+    size_t estimatedBytes = 0;
+};
+
 class SelectionManager {
 public:
     SelectionManager();
@@ -47,7 +57,13 @@ public:
     void SetSelectionMode(SelectionMode mode);
     SelectionMode GetSelectionMode() const { return m_currentMode; }
     
-    // 选择操作
+    // 只切换已登记形状上激活的选择模式，不清除选择也不改高亮样式
+    void ActivateMode(SelectionMode mode);
+    // 在单个显示对象上激活当前模式（其他模式停用）；
+    // 各模式的选择结构首次激活时才计算，停用后保留在对象上供再次切换复用
+    void ActivateSelection(const Handle(AIS_Shape)& aisShape);
+    
+    // 选择操作：只更新上下文状态不重绘，由调用方请求重绘
     void StartSelection(int x, int y);
     void UpdateSelection(int x, int y);
     void EndSelection(int x, int y);
@@ -57,6 +73,11 @@ public:
     void AddToSelection(int x, int y);
     void RemoveFromSelection(int x, int y);
     
+    // 框选/套索选择（视图像素坐标）：直接用选择器的矩形/多段线拾取遍历BVH，
+    // 不经过上下文的逐个owner高亮；返回本次拾取到的子形状（当前模式，已去重）
+    std::vector<SelectionInfo> SelectInRectangle(int xMin, int yMin, int xMax, int yMax, bool addToSelection = false);
+    std::vector<SelectionInfo> SelectInPolygon(const std::vector<std::pair<int, int>>& points, bool addToSelection = false);
+    
     // 获取选择结果
     std::vector<SelectionInfo> GetSelectedShapes() const;
     std::vector<SelectionInfo> GetSelectedFaces() const;
@@ -74,6 +95,14 @@ public:
     void HighlightShape(const Handle(AIS_Shape)& shape, bool highlight = true);
     void HighlightAll(bool highlight = true);
     
+    // 登记显示对象对应的形状，拾取时复用同一个Shape（及其拓扑索引）
+    void RegisterShape(const Handle(AIS_Shape)& aisShape, const ShapePtr& shape);
+    void UnregisterShape(const Handle(AIS_Shape)& aisShape);
+    void ClearRegisteredShapes();
+    
+    // 按形状统计已计算的选择结构
+    std::vector<SelectionMemoryInfo> GetSelectionMemoryReport() const;
+    
     // 选择过滤
     void EnableShapeSelection(bool enable = true);
     void EnableFaceSelection(bool enable = true);
@@ -85,12 +114,19 @@ private:
     Handle(V3d_View) m_view;
     SelectionMode m_currentMode;
     std::vector<SelectionInfo> m_selectedItems;
+    struct RegisteredShape {
+        Handle(AIS_Shape) aisShape;
+        ShapePtr shape;
+    };
+    std::unordered_map<const AIS_InteractiveObject*, RegisteredShape> m_registeredShapes;
     
     // 私有方法
     void UpdateSelectionMode();
     SelectionInfo CreateSelectionInfo(const Handle(AIS_Shape)& aisShape, int subShapeIndex = -1);
-    TopoDS_Shape GetSubShape(const TopoDS_Shape& shape, TopAbs_ShapeEnum type, int index);
-    int GetSubShapeIndex(const TopoDS_Shape& shape, const TopoDS_Shape& subShape, TopAbs_ShapeEnum type);
+    std::vector<SelectionInfo> CollectPickedOwners(bool addToSelection);
+    ShapePtr ResolveShape(const Handle(AIS_Shape)& aisShape) const;
+    TopoDS_Shape GetSubShape(const ShapePtr& shape, TopAbs_ShapeEnum type, int index);
+    int GetSubShapeIndex(const ShapePtr& shape, const TopoDS_Shape& subShape, TopAbs_ShapeEnum type);
 };
 
 } // namespace cad_core
\ No newline at end of file
@@ -5,7 +5,6 @@
  * 这个类封装了OpenCASCADE的TopoDS_Shape，让我们能够更优雅地处理几何体
  * 不得不说OpenCASCADE的命名真的很有特色...TopoDS是什么鬼名字？😅
  * 
- * TODO: 添加更多几何属性计算（重心、包围盒等）
  * TODO: 考虑添加形状变换功能
  * TODO: 实现形状的序列化和反序列化
  */
@@ -13,10 +12,28 @@
 #pragma once
 
 #include <TopoDS_Shape.hxx>
+#include <Bnd_Box.hxx>
+#include <Bnd_OBB.hxx>
+#include "cad_core/TopologyIndex.h"
+#include "cad_core/TopologyQuery.h"
+#include <gp_Pnt.hxx>
+#include <gp_Mat.hxx>
+#include <future>
 #include <memory>
 
 namespace cad_core {
 
+/**
+ * @struct ShapeProperties
+ * @brief 形状的质量属性 - 一次算好，反复使用
+ */
+struct ShapeProperties {
+    double volume = 0.0;   ///< 体积
+    double area = 0.0;     ///< 表面积
+    gp_Pnt centroid;       ///< 重心（实体按体积，否则按表面）
+    gp_Mat inertia;        ///< 相对重心的惯性矩阵
+};
+
 /**
  * @class Shape
  * @brief 几何形状的包装类，让OpenCASCADE变得"人性化"一点
@@ -69,10 +86,108 @@ public:
      * TODO: 对于非封闭形状可能需要特殊处理
      */
     double Area() const;
+    
+    /** 
+     * 计算重心 - 实体按体积，其它形状按表面
+     * @return 重心坐标
+     */
+    gp_Pnt Centroid() const;
+    
+    /** 
+     * 计算惯性矩阵 - 相对重心
+     * @return 惯性矩阵
+     */
+    gp_Mat Inertia() const;
+    
+    /** 
+     * 获取全部质量属性 - 第一次调用时计算并缓存，
+     * 如果后台计算正在进行，就等它算完
+     * @return 质量属性
+     */
+    const ShapeProperties& GetProperties() const;
+    
+    /** 
+     * 在后台线程计算质量属性 - 大模型选中时不卡界面
+     * 已经算过或正在算时什么都不做
+     */
+    void ComputePropertiesAsync() const;
+    
+    /** 
+     * 质量属性是否已经算好 - 算好了再读就不会阻塞
+     * @return true如果可以立即读取
+     */
+    bool ArePropertiesReady() const;
+    
+    /** 
+     * 设置质量属性的计算精度
+     * @param precision 相对误差，0表示使用默认的高斯积分（最快）
+     */
+    void SetPropertiesPrecision(double precision);
+    double GetPropertiesPrecision() const;
+    
+    /** 
+     * 获取轴对齐包围盒 - 第一次调用时计算，之后直接复用
+     * 按精确几何（而非网格）计算并包含容差，保证不会"漏掉"任何部分
+     * @return 包围盒，空形状返回Void的盒子
+     */
+    const Bnd_Box& GetBoundingBox() const;
+    
+    /** 
+     * 获取有向包围盒 - 对斜放的零件比轴对齐包围盒贴合得多
+     * 同样是懒计算并缓存
+     * @return 有向包围盒
+     */
+    const Bnd_OBB& GetOrientedBoundingBox() const;
+    
+    /** 
+     * 获取拓扑索引 - 面/边/顶点编号和边→面邻接关系，第一次调用时构建
+     * 圆角验证、拾取等频繁查询都走这里，不用每次重新遍历整个模型
+     * @return 拓扑索引（只读，形状的各个拷贝之间共享）
+     */
+    const TopologyIndex& GetTopologyIndex() const;
+    
+    /** 
+     * 获取拓扑查询引擎 - 在拓扑索引之上按曲面/曲线类型和参数分好类
+     * "所有半径3的圆边""所有法向+Z的平面"这类查询不用再一个个点选
+     * @return 拓扑查询（只读，同样懒构建、拷贝之间共享）
+     */
+    const TopologyQuery& GetTopologyQuery() const;
+    
+    /** 
+     * 标记形状已通过有效性检查 - 验证过一次，下游就不用再查了
+     * @param validated 是否已验证
+     */
+    void SetValidated(bool validated);
+    
+    /** 
+     * 是否已通过有效性检查
+     * @return true如果已验证且有效
+     */
+    bool IsValidated() const;
 
 private:
     /** 存储实际的OpenCASCADE形状 - 我们的"内核" */
     TopoDS_Shape m_shape;
+    
+    /** 包围盒缓存，SetOCCTShape时失效 */
+    mutable Bnd_Box m_boundingBox;
+    mutable Bnd_OBB m_orientedBoundingBox;
+    mutable bool m_hasBoundingBox = false;
+    mutable bool m_hasOrientedBoundingBox = false;
+    
+    /** 质量属性缓存，后台计算时也通过它取结果 */
+    mutable std::shared_future<ShapeProperties> m_properties;
+    double m_propertiesPrecision = 0.0;
+    
+    /** 真正干活的计算函数，不访问任何成员，可以放心丢到后台线程 */
+    static ShapeProperties ComputeProperties(const TopoDS_Shape& shape, double precision);
+    
+    /** 拓扑索引缓存，构建后只读，所以拷贝时可以共享 */
+    mutable std::shared_ptr<const TopologyIndex> m_topologyIndex;
+    mutable std::shared_ptr<const TopologyQuery> m_topologyQuery;
+    
+    /** 验证标记，SetOCCTShape时清除 */
+    bool m_validated = false;
 };
 
 /** 智能指针类型别名 - 现代C++的标配，内存管理不用愁 */
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "cad_core/Shape.h"
+#include <BRepTools_History.hxx>
+#include <TopTools_ListOfShape.hxx>
+
+namespace cad_core {
+
+// 运算结果的验证策略
+enum class ValidationPolicy {
+    None,   // 不验证
+    Fast,   // 只检查运算修改/生成的面（依据运算历史）
+    Full    // 完整检查整个结果
+};
+
+class ShapeValidator {
+public:
+    // 按策略验证结果，通过时给形状打上"已验证"标记
+    // Fast策略需要运算历史，没有历史时退回Full
+    static bool Validate(const ShapePtr& result, ValidationPolicy policy,
+                         const TopTools_ListOfShape& arguments = TopTools_ListOfShape(),
+                         const Handle(BRepTools_History)& history = Handle(BRepTools_History)());
+    
+    // 完整检查，已验证过的形状直接返回
+    static bool CheckShape(const ShapePtr& shape);
+    
+    // 并行检查
+    static void SetRunParallel(bool enabled);
+    static bool GetRunParallel();
+    
+private:
+    static bool CheckModifiedFaces(const TopoDS_Shape& result, const TopTools_ListOfShape& arguments,
+                                   const Handle(BRepTools_History)& history);
+    static bool RunAnalyzer(const TopoDS_Shape& shape);
+    
+    static bool s_runParallel;
+};
+
+} // namespace cad_core
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopAbs_ShapeEnum.hxx>
+#include <vector>
+
+namespace cad_core {
+
+// 形状的拓扑索引：面/边/顶点的编号映射以及边→面的邻接关系
+// 构建一次后只读，由Shape懒构建并缓存（见Shape::GetTopologyIndex）
+class TopologyIndex {
+public:
+    explicit TopologyIndex(const TopoDS_Shape& shape);
+    
+    // 子形状映射（TopTools约定，索引从1开始）
+    const TopTools_IndexedMapOfShape& GetFaces() const { return m_faces; }
+    const TopTools_IndexedMapOfShape& GetEdges() const { return m_edges; }
+    const TopTools_IndexedMapOfShape& GetVertices() const { return m_vertices; }
+    const TopTools_IndexedMapOfShape* GetSubShapes(TopAbs_ShapeEnum type) const;
+    
+    // 基于0的索引访问，与SelectionInfo::index一致
+    TopoDS_Shape GetSubShape(TopAbs_ShapeEnum type, int index) const;
+    int GetSubShapeIndex(const TopoDS_Shape& subShape, TopAbs_ShapeEnum type) const;
+    bool Contains(const TopoDS_Shape& subShape) const;
+    
+    // 边的相邻面
+    std::vector<TopoDS_Face> GetAdjacentFaces(const TopoDS_Edge& edge) const;
+    int GetAdjacentFaceCount(const TopoDS_Edge& edge) const;
+    
+private:
+    TopTools_IndexedMapOfShape m_faces;
+    TopTools_IndexedMapOfShape m_edges;
+    TopTools_IndexedMapOfShape m_vertices;
+    TopTools_IndexedDataMapOfShapeListOfShape m_edgeFaces;
+};
+
+} // namespace cad_core
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "cad_core/TopologyIndex.h"
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <GeomAbs_SurfaceType.hxx>
+#include <GeomAbs_CurveType.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Dir.hxx>
+#include <Precision.hxx>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace cad_core {
+
+// 面的几何分类：曲面类型及其主要参数
+struct FaceGeometry {
+    GeomAbs_SurfaceType type = GeomAbs_OtherSurface;
+    gp_Ax1 axis;               // 平面：面上一点+外法向（已考虑面朝向）；回转面：回转轴
+    double radius = 0.0;       // 圆柱/球半径，圆锥参考半径，圆环大半径
+    double minorRadius = 0.0;  // 圆环小半径，圆锥半角
+};
+
+// 边的几何分类：曲线类型及其主要参数
+struct EdgeGeometry {
+    GeomAbs_CurveType type = GeomAbs_OtherCurve;
+    gp_Ax1 axis;               // 直线：起点+方向；圆/椭圆：圆心+法向
+    double radius = 0.0;       // 圆半径，椭圆长半轴
+    double minorRadius = 0.0;  // 椭圆短半轴
+    bool degenerated = false;
+};
+
+// 形状的拓扑查询引擎：在TopologyIndex的编号之上，把面/边按几何类型和参数分类建索引，
+// 之后按谓词查询只需查表或二分，不再逐个做几何适配。
+// 构建一次后只读，由Shape懒构建并缓存（见Shape::GetTopologyQuery）。
+// 所有结果都是基于0的子形状索引，与TopologyIndex::GetSubShape/SelectionInfo::index一致
+class TopologyQuery {
+public:
+    explicit TopologyQuery(std::shared_ptr<const TopologyIndex> index);
+
+    const TopologyIndex& GetTopologyIndex() const { return *m_index; }
+    const FaceGeometry& GetFaceGeometry(int faceIndex) const { return m_faceGeometry[faceIndex]; }
+    const EdgeGeometry& GetEdgeGeometry(int edgeIndex) const { return m_edgeGeometry[edgeIndex]; }
+
+    // 按类型查询（查表）
+    const std::vector<int>& FindFaces(GeomAbs_SurfaceType type) const;
+    const std::vector<int>& FindEdges(GeomAbs_CurveType type) const;
+
+    // 按半径查询（排序数组上二分），|r - radius| <= tolerance
+    std::vector<int> FindCircularEdges(double radius, double tolerance = Precision::Confusion()) const;
+    std::vector<int> FindCylindricalFaces(double radius, double tolerance = Precision::Confusion()) const;
+
+    // 外法向与direction夹角不超过angularTolerance的平面
+    std::vector<int> FindPlanarFaces(const gp_Dir& normal, double angularTolerance = Precision::Angular()) const;
+    // 与direction平行（同向或反向）的直线边
+    std::vector<int> FindLinearEdges(const gp_Dir& direction, double angularTolerance = Precision::Angular()) const;
+
+    // 任意谓词，只遍历已分类的参数，不再访问几何
+    std::vector<int> FindFaces(const std::function<bool(const FaceGeometry&)>& predicate) const;
+    std::vector<int> FindEdges(const std::function<bool(const EdgeGeometry&)>& predicate) const;
+
+    // 一组面的所有边（去重，跳过退化边），例如"顶面的全部边倒角"
+    std::vector<int> GetEdgesOfFaces(const std::vector<int>& faceIndices) const;
+
+    // 索引转成子形状，可直接交给圆角/倒角
+    std::vector<TopoDS_Edge> GetEdges(const std::vector<int>& edgeIndices) const;
+    std::vector<TopoDS_Face> GetFaces(const std::vector<int>& faceIndices) const;
+
+private:
+    std::shared_ptr<const TopologyIndex> m_index;
+    std::vector<FaceGeometry> m_faceGeometry;
+    std::vector<EdgeGeometry> m_edgeGeometry;
+    std::map<GeomAbs_SurfaceType, std::vector<int>> m_facesByType;
+    std::map<GeomAbs_CurveType, std::vector<int>> m_edgesByType;
+    std::vector<std::pair<double, int>> m_circleEdgesByRadius;     // 按半径升序
+    std::vector<std::pair<double, int>> m_cylinderFacesByRadius;   // 按半径升序
+
+    static FaceGeometry ClassifyFace(const TopoDS_Face& face);
+    static EdgeGeometry ClassifyEdge(const TopoDS_Edge& edge);
+    static std::vector<int> FindInRadiusRange(const std::vector<std::pair<double, int>>& sorted,
+                                              double radius, double tolerance);
+};
+
+} // namespace cad_core
\ No newline at end of file
@@ -37,12 +37,22 @@ public:
     // 获取变换后的形状（用于预览）
     std::vector<ShapePtr> GetTransformedShapes() const;
     
+    // 预览用：变换矩阵及其作用的原始形状，视图可直接把矩阵设到已有的显示对象上
+    // HasExactTransformation为false时矩阵只是近似，只能用GetTransformedShapes预览
+    gp_Trsf GetTransformation() const { return CreateTransformation(); }
+    virtual bool HasExactTransformation() const { return true; }
+    const std::vector<ShapePtr>& GetOriginalShapes() const { return m_originalShapes; }
+    
     // 设置变换参数（由派生类具体实现）
     virtual void SetTransformParameters() = 0;
     
 protected:
     virtual gp_Trsf CreateTransformation() const = 0;
     virtual const char* GetTypeName() const = 0;
+    
+    // 对单个形状应用变换，失败返回nullptr
+    // 默认按刚体变换处理：只在共享的TShape上组合TopLoc_Location，几何和网格不复制
+    virtual ShapePtr TransformShape(const ShapePtr& shape, const gp_Trsf& transformation) const;
 
     std::vector<ShapePtr> m_originalShapes;
     std::vector<ShapePtr> m_transformedShapes;
@@ -113,10 +123,14 @@ public:
     void SetScaleCenter(const Point& centerPoint);
     void SetUniformScale(double scaleFactor);
     void SetNonUniformScale(double scaleX, double scaleY, double scaleZ);
+    
+    bool HasExactTransformation() const override { return m_isUniform; }
 
 protected:
     gp_Trsf CreateTransformation() const override;
     const char* GetTypeName() const override;
+    // 缩放会改变几何，不能只靠Location表达
+    ShapePtr TransformShape(const ShapePtr& shape, const gp_Trsf& transformation) const override;
 
 private:
     Point m_centerPoint;
@@ -2,51 +2,74 @@
 #include <BRepAlgoAPI_Fuse.hxx>
 #include <BRepAlgoAPI_Common.hxx>
 #include <BRepAlgoAPI_Cut.hxx>
-#include <BRepCheck_Analyzer.hxx>
+#include <BOPAlgo_CellsBuilder.hxx>
 #include <ShapeFix_Shape.hxx>
+#include <ShapeFix_Wireframe.hxx>
+#include <ShapeFix_FixSmallFace.hxx>
+#include <ShapeUpgrade_UnifySameDomain.hxx>
 #include <BRepBuilderAPI_MakeShape.hxx>
+#include <BRep_Builder.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
 #include <Standard_Failure.hxx>
+#include <algorithm>
 
 namespace cad_core {
 
+bool BooleanOperations::s_runParallel = true;
+double BooleanOperations::s_fuzzyValue = 0.0;
+ValidationPolicy BooleanOperations::s_validationPolicy = ValidationPolicy::Full;
+bool BooleanOperations::s_resultCacheEnabled = true;
+BooleanResultCache BooleanOperations::s_resultCache;
+bool BooleanOperations::s_simplifyResults = true;
+double BooleanOperations::s_smallFeatureTolerance = 0.0;
+SimplifyStatistics BooleanOperations::s_lastSimplifyStatistics;
+
 ShapePtr BooleanOperations::Union(const ShapePtr& shape1, const ShapePtr& shape2) {
-    return PerformUnion(shape1, shape2);
+    return CachedOperation(BooleanType::Union, {shape1, shape2},
+                           [&]() { return PerformUnion(shape1, shape2); });
 }
 
 ShapePtr BooleanOperations::Union(const std::vector<ShapePtr>& shapes) {
     if (shapes.empty()) return nullptr;
     if (shapes.size() == 1) return shapes[0];
+    if (shapes.size() == 2) return Union(shapes[0], shapes[1]);
     
-    ShapePtr result = shapes[0];
-    for (size_t i = 1; i < shapes.size(); i++) {
-        result = Union(result, shapes[i]);
-        if (!result) return nullptr;
-    }
-    
-    return result;
+    return CachedOperation(BooleanType::Union, shapes,
+                           [&]() { return PerformMultiUnion(shapes); });
 }
 
 ShapePtr BooleanOperations::Intersection(const ShapePtr& shape1, const ShapePtr& shape2) {
-    return PerformIntersection(shape1, shape2);
+    return CachedOperation(BooleanType::Intersection, {shape1, shape2},
+                           [&]() { return PerformIntersection(shape1, shape2); });
 }
 
 ShapePtr BooleanOperations::Intersection(const std::vector<ShapePtr>& shapes) {
     if (shapes.empty()) return nullptr;
     if (shapes.size() == 1) return shapes[0];
+    if (shapes.size() == 2) return Intersection(shapes[0], shapes[1]);
     
-    ShapePtr result = shapes[0];
-    for (size_t i = 1; i < shapes.size(); i++) {
-        result = Intersection(result, shapes[i]);
-        if (!result) return nullptr;
-    }
-    
-    return result;
+    return CachedOperation(BooleanType::Intersection, shapes,
+                           [&]() { return PerformMultiIntersection(shapes); });
 }
 
 ShapePtr BooleanOperations::Difference(const ShapePtr& shape1, const ShapePtr& shape2) {
-    return PerformDifference(shape1, shape2);
+    return CachedOperation(BooleanType::Difference, {shape1, shape2},
+                           [&]() { return PerformDifference(shape1, shape2); });
+}
+
+ShapePtr BooleanOperations::Difference(const ShapePtr& target, const std::vector<ShapePtr>& tools) {
+    if (!target) return nullptr;
+    if (tools.empty()) return target;
+    if (tools.size() == 1) return Difference(target, tools[0]);
+    
+    std::vector<ShapePtr> operands;
+    operands.reserve(tools.size() + 1);
+    operands.push_back(target);
+    operands.insert(operands.end(), tools.begin(), tools.end());
+    return CachedOperation(BooleanType::Difference, operands,
+                           [&]() { return PerformMultiDifference(target, tools); });
 }
 
 ShapePtr BooleanOperations::BooleanOperation(const ShapePtr& shape1, const ShapePtr& shape2, BooleanType type) {
@@ -69,9 +92,9 @@ ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& shapes
         case BooleanType::Intersection:
             return Intersection(shapes);
         case BooleanType::Difference:
-            // 对于差集操作，我们只能处理两个形状
-            if (shapes.size() == 2) {
-                return Difference(shapes[0], shapes[1]);
+            // 第一个形状为目标，其余形状都作为工具一次性减去
+            if (shapes.size() >= 2) {
+                return Difference(shapes[0], std::vector<ShapePtr>(shapes.begin() + 1, shapes.end()));
             }
             return nullptr;
         default:
@@ -80,12 +103,7 @@ ShapePtr BooleanOperations::BooleanOperation(const std::vector<ShapePtr>& shapes
 }
 
 bool BooleanOperations::IsValidShape(const ShapePtr& shape) {
-    if (!shape || shape->GetOCCTShape().IsNull()) {
-        return false;
-    }
-    
-    BRepCheck_Analyzer analyzer(shape->GetOCCTShape());
-    return analyzer.IsValid();
+    return ShapeValidator::CheckShape(shape);
 }
 
 ShapePtr BooleanOperations::FixShape(const ShapePtr& shape) {
@@ -109,34 +127,174 @@ ShapePtr BooleanOperations::FixShape(const ShapePtr& shape) {
     return shape;
 }
 
-ShapePtr BooleanOperations::SimplifyShape(const ShapePtr& shape) {
+ShapePtr BooleanOperations::SimplifyShape(const ShapePtr& shape, SimplifyStatistics* statistics,
+                                          const Handle(BRepTools_History)& history) {
     if (!shape || shape->GetOCCTShape().IsNull()) {
         return nullptr;
     }
     
-    // 简化形状的实现可以在这里添加
-    // 目前返回原形状
+    if (statistics) {
+        const TopologyIndex& index = shape->GetTopologyIndex();
+        statistics->facesBefore = statistics->facesAfter = index.GetFaces().Extent();
+        statistics->edgesBefore = statistics->edgesAfter = index.GetEdges().Extent();
+    }
+    
+    try {
+        TopoDS_Shape current = shape->GetOCCTShape();
+        
+        // 去除小于阈值的边和退化的细长面
+        if (s_smallFeatureTolerance > 0.0) {
+            Handle(ShapeFix_Wireframe) wireFixer = new ShapeFix_Wireframe(current);
+            wireFixer->SetPrecision(s_smallFeatureTolerance);
+            wireFixer->ModeDropSmallEdges() = Standard_True;
+            wireFixer->FixSmallEdges();
+            wireFixer->FixWireGaps();
+            current = wireFixer->Shape();
+            
+            ShapeFix_FixSmallFace faceFixer;
+            faceFixer.Init(current);
+            faceFixer.SetPrecision(s_smallFeatureTolerance);
+            current = faceFixer.FixShape();
+        }
+        
+        // 合并布尔运算留下的共面分割面和位于同一曲线上的边
+        ShapeUpgrade_UnifySameDomain unifier(current, Standard_True, Standard_True, Standard_False);
+        unifier.AllowInternalEdges(Standard_False);
+        unifier.Build();
+        current = unifier.Shape();
+        
+        if (current.IsNull()) {
+            return shape;
+        }
+        
+        if (!history.IsNull()) {
+            history->Merge(unifier.History());
+        }
+        
+        ShapePtr simplified = std::make_shared<Shape>(current);
+        if (statistics) {
+            const TopologyIndex& index = simplified->GetTopologyIndex();
+            statistics->facesAfter = index.GetFaces().Extent();
+            statistics->edgesAfter = index.GetEdges().Extent();
+        }
+        return simplified;
+    } catch (const Standard_Failure& e) {
+        // 简化失败，返回原形状
+    }
+    
     return shape;
 }
 
+void BooleanOperations::SetSimplifyResults(bool enabled) {
+    if (s_simplifyResults != enabled) {
+        // 缓存的结果是按旧设置生成的
+        s_resultCache.Clear();
+    }
+    s_simplifyResults = enabled;
+}
+
+bool BooleanOperations::IsSimplifyResultsEnabled() {
+    return s_simplifyResults;
+}
+
+void BooleanOperations::SetSmallFeatureTolerance(double tolerance) {
+    tolerance = tolerance > 0.0 ? tolerance : 0.0;
+    if (s_smallFeatureTolerance != tolerance) {
+        s_resultCache.Clear();
+    }
+    s_smallFeatureTolerance = tolerance;
+}
+
+double BooleanOperations::GetSmallFeatureTolerance() {
+    return s_smallFeatureTolerance;
+}
+
+const SimplifyStatistics& BooleanOperations::GetLastSimplifyStatistics() {
+    return s_lastSimplifyStatistics;
+}
+
+void BooleanOperations::SetRunParallel(bool enabled) {
+    s_runParallel = enabled;
+}
+
+bool BooleanOperations::GetRunParallel() {
+    return s_runParallel;
+}
+
+void BooleanOperations::SetFuzzyValue(double value) {
+    s_fuzzyValue = value > 0.0 ? value : 0.0;
+}
+
+double BooleanOperations::GetFuzzyValue() {
+    return s_fuzzyValue;
+}
+
+void BooleanOperations::SetValidationPolicy(ValidationPolicy policy) {
+    if (s_validationPolicy != policy) {
+        // 缓存的结果是按旧策略验证（或未验证）的
+        s_resultCache.Clear();
+    }
+    s_validationPolicy = policy;
+}
+
+ValidationPolicy BooleanOperations::GetValidationPolicy() {
+    return s_validationPolicy;
+}
+
+void BooleanOperations::SetResultCacheEnabled(bool enabled) {
+    s_resultCacheEnabled = enabled;
+    if (!enabled) {
+        s_resultCache.Clear();
+    }
+}
+
+bool BooleanOperations::IsResultCacheEnabled() {
+    return s_resultCacheEnabled;
+}
+
+BooleanResultCache& BooleanOperations::GetResultCache() {
+    return s_resultCache;
+}
+
+ShapePtr BooleanOperations::CachedOperation(BooleanType type, const std::vector<ShapePtr>& operands,
+                                            const std::function<ShapePtr()>& operation) {
+    // 缓存命中和包围盒快速路径不做简化，不能留下上一次运算的统计
+    s_lastSimplifyStatistics = SimplifyStatistics();
+    
+    if (!s_resultCacheEnabled) {
+        return operation();
+    }
+    
+    int key = static_cast<int>(type);
+    ShapePtr cached = s_resultCache.Find(key, operands, s_fuzzyValue);
+    if (cached) {
+        return cached;
+    }
+    
+    ShapePtr result = operation();
+    if (result) {
+        s_resultCache.Insert(key, operands, s_fuzzyValue, result);
+    }
+    return result;
+}
+
 ShapePtr BooleanOperations::PerformUnion(const ShapePtr& shape1, const ShapePtr& shape2) {
     if (!ValidateInputs(shape1, shape2)) {
         return nullptr;
     }
     
-    try {
-        BRepAlgoAPI_Fuse fuseOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
-        fuseOp.Build();
-        
-        if (fuseOp.IsDone()) {
-            TopoDS_Shape result = fuseOp.Shape();
-            return PostProcessResult(result);
-        }
-    } catch (const Standard_Failure& e) {
-        // 布尔运算失败
+    // 互不接触的形状，并集就是两者的组合
+    if (!BoundingBoxesOverlap(shape1, shape2)) {
+        return MakeCompound({shape1, shape2});
     }
     
-    return nullptr;
+    TopTools_ListOfShape arguments;
+    TopTools_ListOfShape tools;
+    arguments.Append(shape1->GetOCCTShape());
+    tools.Append(shape2->GetOCCTShape());
+    
+    BRepAlgoAPI_Fuse fuseOp;
+    return RunOperation(fuseOp, arguments, tools);
 }
 
 ShapePtr BooleanOperations::PerformIntersection(const ShapePtr& shape1, const ShapePtr& shape2) {
@@ -144,13 +302,152 @@ ShapePtr BooleanOperations::PerformIntersection(const ShapePtr& shape1, const Sh
         return nullptr;
     }
     
+    // 互不接触的形状，交集为空（与BRepAlgoAPI_Common一样返回空组合体）
+    if (!BoundingBoxesOverlap(shape1, shape2)) {
+        return MakeCompound({});
+    }
+    
+    TopTools_ListOfShape arguments;
+    TopTools_ListOfShape tools;
+    arguments.Append(shape1->GetOCCTShape());
+    tools.Append(shape2->GetOCCTShape());
+    
+    BRepAlgoAPI_Common commonOp;
+    return RunOperation(commonOp, arguments, tools);
+}
+
+ShapePtr BooleanOperations::PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2) {
+    if (!ValidateInputs(shape1, shape2)) {
+        return nullptr;
+    }
+    
+    // 工具碰不到目标，目标保持不变
+    if (!BoundingBoxesOverlap(shape1, shape2)) {
+        return std::make_shared<Shape>(shape1->GetOCCTShape());
+    }
+    
+    TopTools_ListOfShape arguments;
+    TopTools_ListOfShape tools;
+    arguments.Append(shape1->GetOCCTShape());
+    tools.Append(shape2->GetOCCTShape());
+    
+    BRepAlgoAPI_Cut cutOp;
+    return RunOperation(cutOp, arguments, tools);
+}
+
+ShapePtr BooleanOperations::PerformMultiUnion(const std::vector<ShapePtr>& shapes) {
+    for (const auto& shape : shapes) {
+        if (!shape || shape->GetOCCTShape().IsNull()) {
+            return nullptr;
+        }
+    }
+    
+    // 按包围盒最小X排序后扫描，只比较X方向上有重叠的形状对
+    std::vector<size_t> order(shapes.size());
+    std::vector<double> xMin(shapes.size()), xMax(shapes.size());
+    for (size_t i = 0; i < shapes.size(); i++) {
+        order[i] = i;
+        const Bnd_Box& box = shapes[i]->GetBoundingBox();
+        if (box.IsVoid()) {
+            xMin[i] = xMax[i] = 0.0;
+        } else {
+            double yMin, zMin, yMax, zMax;
+            box.Get(xMin[i], yMin, zMin, xMax[i], yMax, zMax);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&xMin](size_t a, size_t b) { return xMin[a] < xMin[b]; });
+    
+    std::vector<bool> touching(shapes.size(), false);
+    for (size_t i = 0; i < order.size(); i++) {
+        for (size_t j = i + 1; j < order.size() && xMin[order[j]] <= xMax[order[i]] + s_fuzzyValue; j++) {
+            size_t a = order[i];
+            size_t b = order[j];
+            if (touching[a] && touching[b]) {
+                continue;
+            }
+            if (BoundingBoxesOverlap(shapes[a], shapes[b])) {
+                touching[a] = true;
+                touching[b] = true;
+            }
+        }
+    }
+    
+    // 与其他形状都不接触的形状不参与求交，最后直接放进组合体
+    std::vector<ShapePtr> isolated;
+    TopTools_ListOfShape arguments;
+    TopTools_ListOfShape tools;
+    for (size_t i = 0; i < shapes.size(); i++) {
+        if (!touching[i]) {
+            isolated.push_back(shapes[i]);
+        } else if (arguments.IsEmpty()) {
+            // 第一个形状作为参数，其余全部作为工具，一次求交即可得到并集
+            arguments.Append(shapes[i]->GetOCCTShape());
+        } else {
+            tools.Append(shapes[i]->GetOCCTShape());
+        }
+    }
+    
+    if (arguments.IsEmpty()) {
+        return MakeCompound(isolated);
+    }
+    
+    BRepAlgoAPI_Fuse fuseOp;
+    ShapePtr fused = RunOperation(fuseOp, arguments, tools);
+    if (!fused || isolated.empty()) {
+        return fused;
+    }
+    
+    isolated.insert(isolated.begin(), fused);
+    return MakeCompound(isolated);
+}
+
+ShapePtr BooleanOperations::PerformMultiIntersection(const std::vector<ShapePtr>& shapes) {
+    TopTools_ListOfShape arguments;
+    double cxMin = -RealLast(), cyMin = -RealLast(), czMin = -RealLast();
+    double cxMax = RealLast(), cyMax = RealLast(), czMax = RealLast();
+    for (const auto& shape : shapes) {
+        if (!shape || shape->GetOCCTShape().IsNull()) {
+            return nullptr;
+        }
+        arguments.Append(shape->GetOCCTShape());
+        
+        // 所有包围盒的公共部分为空时，交集必然为空
+        const Bnd_Box& box = shape->GetBoundingBox();
+        if (box.IsVoid()) {
+            return MakeCompound({});
+        }
+        double xMin, yMin, zMin, xMax, yMax, zMax;
+        box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        cxMin = std::max(cxMin, xMin - s_fuzzyValue);
+        cyMin = std::max(cyMin, yMin - s_fuzzyValue);
+        czMin = std::max(czMin, zMin - s_fuzzyValue);
+        cxMax = std::min(cxMax, xMax);
+        cyMax = std::min(cyMax, yMax);
+        czMax = std::min(czMax, zMax);
+        if (cxMin > cxMax || cyMin > cyMax || czMin > czMax) {
+            return MakeCompound({});
+        }
+    }
+    
     try {
-        BRepAlgoAPI_Common commonOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
-        commonOp.Build();
+        // Common(参数, 工具)只能求两组的交集，这里用Cells Builder
+        // 一次性拆分所有参数，然后只保留位于每个参数内部的单元
+        BOPAlgo_CellsBuilder cellsBuilder;
+        cellsBuilder.SetArguments(arguments);
+        cellsBuilder.SetRunParallel(s_runParallel);
+        if (s_fuzzyValue > 0.0) {
+            cellsBuilder.SetFuzzyValue(s_fuzzyValue);
+        }
+        cellsBuilder.Perform();
         
-        if (commonOp.IsDone()) {
-            TopoDS_Shape result = commonOp.Shape();
-            return PostProcessResult(result);
+        if (!cellsBuilder.HasErrors()) {
+            TopTools_ListOfShape toAvoid;
+            cellsBuilder.AddToResult(arguments, toAvoid);
+            Handle(BRepTools_History) history;
+            if (s_validationPolicy == ValidationPolicy::Fast) {
+                history = cellsBuilder.History();
+            }
+            return PostProcessResult(cellsBuilder.Shape(), arguments, history);
         }
     } catch (const Standard_Failure& e) {
         // 布尔运算失败
@@ -159,18 +456,61 @@ ShapePtr BooleanOperations::PerformIntersection(const ShapePtr& shape1, const Sh
     return nullptr;
 }
 
-ShapePtr BooleanOperations::PerformDifference(const ShapePtr& shape1, const ShapePtr& shape2) {
-    if (!ValidateInputs(shape1, shape2)) {
+ShapePtr BooleanOperations::PerformMultiDifference(const ShapePtr& target, const std::vector<ShapePtr>& tools) {
+    if (!target || target->GetOCCTShape().IsNull()) {
         return nullptr;
     }
     
+    TopTools_ListOfShape arguments;
+    TopTools_ListOfShape toolList;
+    arguments.Append(target->GetOCCTShape());
+    for (const auto& tool : tools) {
+        if (!tool || tool->GetOCCTShape().IsNull()) {
+            return nullptr;
+        }
+        // 碰不到目标的工具直接丢弃
+        if (BoundingBoxesOverlap(target, tool)) {
+            toolList.Append(tool->GetOCCTShape());
+        }
+    }
+    
+    if (toolList.IsEmpty()) {
+        return std::make_shared<Shape>(target->GetOCCTShape());
+    }
+    
+    // 所有工具在同一次切割中处理，目标只重建和验证一次
+    BRepAlgoAPI_Cut cutOp;
+    return RunOperation(cutOp, arguments, toolList);
+}
+
+ShapePtr BooleanOperations::RunOperation(BRepAlgoAPI_BooleanOperation& operation,
+                                         const TopTools_ListOfShape& arguments,
+                                         const TopTools_ListOfShape& tools) {
     try {
-        BRepAlgoAPI_Cut cutOp(shape1->GetOCCTShape(), shape2->GetOCCTShape());
-        cutOp.Build();
+        operation.SetArguments(arguments);
+        operation.SetTools(tools);
+        operation.SetRunParallel(s_runParallel);
+        if (s_fuzzyValue > 0.0) {
+            operation.SetFuzzyValue(s_fuzzyValue);
+        }
+        operation.Build();
         
-        if (cutOp.IsDone()) {
-            TopoDS_Shape result = cutOp.Shape();
-            return PostProcessResult(result);
+        if (operation.IsDone()) {
+            TopoDS_Shape result = operation.Shape();
+            
+            // 只有Fast策略才需要运算历史
+            TopTools_ListOfShape operands;
+            Handle(BRepTools_History) history;
+            if (s_validationPolicy == ValidationPolicy::Fast) {
+                for (TopTools_ListIteratorOfListOfShape it(arguments); it.More(); it.Next()) {
+                    operands.Append(it.Value());
+                }
+                for (TopTools_ListIteratorOfListOfShape it(tools); it.More(); it.Next()) {
+                    operands.Append(it.Value());
+                }
+                history = operation.History();
+            }
+            return PostProcessResult(result, operands, history);
         }
     } catch (const Standard_Failure& e) {
         // 布尔运算失败
@@ -179,6 +519,38 @@ ShapePtr BooleanOperations::PerformDifference(const ShapePtr& shape1, const Shap
     return nullptr;
 }
 
+bool BooleanOperations::BoundingBoxesOverlap(const ShapePtr& shape1, const ShapePtr& shape2) {
+    // 模糊容差内相距的形状也会被布尔运算视为接触，所以包围盒要相应放大
+    Bnd_Box box1 = shape1->GetBoundingBox();
+    const Bnd_Box& box2 = shape2->GetBoundingBox();
+    if (box1.IsVoid() || box2.IsVoid()) {
+        return false;
+    }
+    box1.Enlarge(s_fuzzyValue);
+    if (box1.IsOut(box2)) {
+        return false;
+    }
+    
+    // AABB重叠时再用OBB确认，斜放的细长零件常常在这里被排除
+    Bnd_OBB obb1 = shape1->GetOrientedBoundingBox();
+    const Bnd_OBB& obb2 = shape2->GetOrientedBoundingBox();
+    if (obb1.IsVoid() || obb2.IsVoid()) {
+        return true;
+    }
+    obb1.Enlarge(s_fuzzyValue);
+    return !obb1.IsOut(obb2);
+}
+
+ShapePtr BooleanOperations::MakeCompound(const std::vector<ShapePtr>& shapes) {
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    for (const auto& shape : shapes) {
+        builder.Add(compound, shape->GetOCCTShape());
+    }
+    return std::make_shared<Shape>(compound);
+}
+
 bool BooleanOperations::ValidateInputs(const ShapePtr& shape1, const ShapePtr& shape2) {
     if (!shape1 || !shape2) {
         return false;
@@ -191,16 +563,28 @@ bool BooleanOperations::ValidateInputs(const ShapePtr& shape1, const ShapePtr& s
     return true;
 }
 
-ShapePtr BooleanOperations::PostProcessResult(const TopoDS_Shape& result) {
+ShapePtr BooleanOperations::PostProcessResult(const TopoDS_Shape& result, const TopTools_ListOfShape& arguments,
+                                              const Handle(BRepTools_History)& history) {
     if (result.IsNull()) {
         return nullptr;
     }
     
     // 创建结果形状
     ShapePtr resultShape = std::make_shared<Shape>(result);
+    Handle(BRepTools_History) resultHistory = history;
+    
+    // 先简化再验证，验证的是最终交给调用方的形状
+    if (s_simplifyResults) {
+        // 合并面/边的修改并入运算历史，Fast策略据此找到简化后的面；
+        // 去小特征的修复没有历史可用，此时退回完整检查
+        if (s_smallFeatureTolerance > 0.0) {
+            resultHistory.Nullify();
+        }
+        resultShape = SimplifyShape(resultShape, &s_lastSimplifyStatistics, resultHistory);
+    }
     
-    // 验证结果
-    if (!IsValidShape(resultShape)) {
+    // 按策略验证结果，通过的结果会带上已验证标记，下游不再重复检查
+    if (!ShapeValidator::Validate(resultShape, s_validationPolicy, arguments, resultHistory)) {
         // 尝试修复
         resultShape = FixShape(resultShape);
     }
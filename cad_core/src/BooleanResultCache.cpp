@@ -0,0 +1,165 @@
+#include "cad_core/BooleanResultCache.h"
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <functional>
+
+namespace cad_core {
+
+BooleanResultCache::BooleanResultCache(size_t memoryBudget)
+    : m_memoryBudget(memoryBudget), m_memoryUsage(0), m_hits(0), m_misses(0), m_evictions(0) {
+}
+
+ShapePtr BooleanResultCache::Find(int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue) {
+    size_t hash = ComputeHash(operationType, operands, fuzzyValue);
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto range = m_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (Matches(*it->second, operationType, operands, fuzzyValue)) {
+            // 移到链表头部，标记为最近使用
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            m_hits++;
+            // 返回新的包装对象，调用者可以像对待新结果一样显示/加入文档
+            return std::make_shared<Shape>(*it->second->result);
+        }
+    }
+    
+    m_misses++;
+    return nullptr;
+}
+
+void BooleanResultCache::Insert(int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue, const ShapePtr& result) {
+    if (!result || result->GetOCCTShape().IsNull()) {
+        return;
+    }
+    
+    Entry entry;
+    entry.operationType = operationType;
+    entry.fuzzyValue = fuzzyValue;
+    entry.result = std::make_shared<Shape>(*result);
+    entry.hash = ComputeHash(operationType, operands, fuzzyValue);
+    entry.size = EstimateSize(result->GetOCCTShape());
+    for (const auto& operand : operands) {
+        entry.operands.push_back(operand ? operand->GetOCCTShape() : TopoDS_Shape());
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    // 单个结果就超出预算的不缓存
+    if (entry.size > m_memoryBudget) {
+        return;
+    }
+    
+    auto range = m_index.equal_range(entry.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (Matches(*it->second, operationType, operands, fuzzyValue)) {
+            m_memoryUsage -= it->second->size;
+            m_entries.erase(it->second);
+            m_index.erase(it);
+            break;
+        }
+    }
+    
+    m_entries.push_front(std::move(entry));
+    m_index.emplace(m_entries.front().hash, m_entries.begin());
+    m_memoryUsage += m_entries.front().size;
+    
+    EvictToBudget();
+}
+
+void BooleanResultCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+    m_memoryUsage = 0;
+}
+
+void BooleanResultCache::SetMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memoryBudget = bytes;
+    EvictToBudget();
+}
+
+size_t BooleanResultCache::GetMemoryBudget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryBudget;
+}
+
+BooleanResultCache::Statistics BooleanResultCache::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Statistics stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.entryCount = m_entries.size();
+    stats.memoryUsage = m_memoryUsage;
+    stats.memoryBudget = m_memoryBudget;
+    return stats;
+}
+
+void BooleanResultCache::ResetStatistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+size_t BooleanResultCache::ComputeHash(int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue) {
+    size_t hash = std::hash<int>()(operationType);
+    auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    
+    combine(std::hash<double>()(fuzzyValue));
+    for (const auto& operand : operands) {
+        combine(operand ? std::hash<TopoDS_Shape>()(operand->GetOCCTShape()) : 0);
+        combine(operand ? static_cast<size_t>(operand->GetOCCTShape().Orientation()) : 0);
+    }
+    return hash;
+}
+
+bool BooleanResultCache::Matches(const Entry& entry, int operationType, const std::vector<ShapePtr>& operands, double fuzzyValue) {
+    if (entry.operationType != operationType || entry.fuzzyValue != fuzzyValue ||
+        entry.operands.size() != operands.size()) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < operands.size(); i++) {
+        const TopoDS_Shape& operand = operands[i] ? operands[i]->GetOCCTShape() : TopoDS_Shape();
+        if (!entry.operands[i].IsEqual(operand)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t BooleanResultCache::EstimateSize(const TopoDS_Shape& shape) {
+    // 粗略估算：按拓扑元素个数乘以每种元素的典型占用（含几何与Shape包装）
+    TopTools_IndexedMapOfShape faces, edges, vertices;
+    TopExp::MapShapes(shape, TopAbs_FACE, faces);
+    TopExp::MapShapes(shape, TopAbs_EDGE, edges);
+    TopExp::MapShapes(shape, TopAbs_VERTEX, vertices);
+    
+    return sizeof(Shape)
+        + static_cast<size_t>(faces.Extent()) * 1024
+        + static_cast<size_t>(edges.Extent()) * 512
+        + static_cast<size_t>(vertices.Extent()) * 128;
+}
+
+void BooleanResultCache::EvictToBudget() {
+    while (m_memoryUsage > m_memoryBudget && !m_entries.empty()) {
+        auto last = std::prev(m_entries.end());
+        auto range = m_index.equal_range(last->hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == last) {
+                m_index.erase(it);
+                break;
+            }
+        }
+        m_memoryUsage -= last->size;
+        m_entries.erase(last);
+        m_evictions++;
+    }
+}
+
+} // namespace cad_core
\ No newline at end of file
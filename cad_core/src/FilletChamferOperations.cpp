@@ -1,24 +1,89 @@
 ﻿#include "cad_core/FilletChamferOperations.h"
 #include <BRepFilletAPI_MakeFillet.hxx>
 #include <BRepFilletAPI_MakeChamfer.hxx>
-#include <BRepCheck_Analyzer.hxx>
+#include <BRepBuilderAPI_MakeShape.hxx>
+#include <BRepTools_History.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopExp.hxx>
 #include <TopoDS.hxx>
+#include <TopTools_MapOfShape.hxx>
 #include <BRep_Tool.hxx>
 #include <GeomAPI_ProjectPointOnCurve.hxx>
 #include <Geom_Curve.hxx>
 #include <GProp_GProps.hxx>
 #include <BRepGProp.hxx>
-#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <OSD_Parallel.hxx>
 #include <Standard_Failure.hxx>
 
 namespace cad_core {
 
+ValidationPolicy FilletChamferOperations::s_validationPolicy = ValidationPolicy::Full;
+
 ShapePtr FilletChamferOperations::CreateFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius) {
     return PerformFillet(shape, edges, radius);
 }
 
+std::vector<FilletChamferBodyResult> FilletChamferOperations::CreateFillet(const EdgesByShape& edgesByShape, double radius,
+                                                                           bool isolateFailures) {
+    return PerformBatch(edgesByShape, radius, true, isolateFailures);
+}
+
+FilletBatchResult FilletChamferOperations::CreateFilletIsolatingFailures(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius) {
+    FilletBatchResult batch;
+    if (!shape || shape->GetOCCTShape().IsNull() || edges.empty() || radius <= 0.0) {
+        return batch;
+    }
+    
+    // 不属于形状或不是两面共享的边直接剔除，不参与构建
+    std::vector<TopoDS_Edge> candidates;
+    for (const auto& edge : edges) {
+        if (!edge.IsNull() && IsValidEdgeForFillet(shape, edge)) {
+            candidates.push_back(edge);
+        } else {
+            batch.rejectedEdges.push_back(edge);
+        }
+    }
+    if (candidates.empty()) {
+        return batch;
+    }
+    
+    // 先整体尝试一次，大多数情况下直接成功
+    std::vector<TopoDS_Edge> faultyEdges;
+    batch.buildCount++;
+    batch.result = TryBuildFillet(shape, candidates, radius, &faultyEdges);
+    if (batch.result) {
+        batch.appliedEdges = candidates;
+        return batch;
+    }
+    
+    // 构建器报告的故障轮廓上的边单独处理，其余边很可能可以一次成功
+    TopTools_MapOfShape faultyMap;
+    for (const auto& edge : faultyEdges) {
+        faultyMap.Add(edge);
+    }
+    std::vector<TopoDS_Edge> healthy;
+    std::vector<TopoDS_Edge> suspects;
+    for (const auto& edge : candidates) {
+        if (faultyMap.Contains(edge)) {
+            suspects.push_back(edge);
+        } else {
+            healthy.push_back(edge);
+        }
+    }
+    
+    if (suspects.empty() || healthy.empty()) {
+        // 没有可用的故障信息，直接对半二分
+        size_t mid = candidates.size() / 2;
+        healthy.assign(candidates.begin(), candidates.begin() + mid);
+        suspects.assign(candidates.begin() + mid, candidates.end());
+    }
+    
+    BisectFilletEdges(shape, healthy, radius, batch);
+    BisectFilletEdges(shape, suspects, radius, batch);
+    
+    return batch;
+}
+
 ShapePtr FilletChamferOperations::CreateFillet(const ShapePtr& shape, const TopoDS_Edge& edge, double radius) {
     std::vector<TopoDS_Edge> edges = {edge};
     return PerformFillet(shape, edges, radius);
@@ -36,7 +101,7 @@ ShapePtr FilletChamferOperations::CreateVariableFillet(const ShapePtr& shape, co
         
         if (fillet.IsDone()) {
             TopoDS_Shape result = fillet.Shape();
-            return PostProcessResult(result);
+            return PostProcessResult(result, shape, fillet);
         }
     } catch (const Standard_Failure& e) {
         // 圆角操作失败
@@ -49,6 +114,10 @@ ShapePtr FilletChamferOperations::CreateChamfer(const ShapePtr& shape, const std
     return PerformChamfer(shape, edges, distance);
 }
 
+std::vector<FilletChamferBodyResult> FilletChamferOperations::CreateChamfer(const EdgesByShape& edgesByShape, double distance) {
+    return PerformBatch(edgesByShape, distance, false, false);
+}
+
 ShapePtr FilletChamferOperations::CreateChamfer(const ShapePtr& shape, const TopoDS_Edge& edge, double distance) {
     std::vector<TopoDS_Edge> edges = {edge};
     return PerformChamfer(shape, edges, distance);
@@ -70,7 +139,7 @@ ShapePtr FilletChamferOperations::CreateAsymmetricChamfer(const ShapePtr& shape,
             
             if (chamfer.IsDone()) {
                 TopoDS_Shape result = chamfer.Shape();
-                return PostProcessResult(result);
+                return PostProcessResult(result, shape, chamfer);
             }
         }
     } catch (const Standard_Failure& e) {
@@ -96,7 +165,7 @@ ShapePtr FilletChamferOperations::CreateChamferByAngle(const ShapePtr& shape, co
             
             if (chamfer.IsDone()) {
                 TopoDS_Shape result = chamfer.Shape();
-                return PostProcessResult(result);
+                return PostProcessResult(result, shape, chamfer);
             }
         }
     } catch (const Standard_Failure& e) {
@@ -122,7 +191,7 @@ ShapePtr FilletChamferOperations::CreateFaceFillet(const ShapePtr& shape, const
         
         if (fillet.IsDone()) {
             TopoDS_Shape result = fillet.Shape();
-            return PostProcessResult(result);
+            return PostProcessResult(result, shape, fillet);
         }
     } catch (const Standard_Failure& e) {
         // 面圆角操作失败
@@ -166,16 +235,8 @@ bool FilletChamferOperations::IsValidEdgeForFillet(const ShapePtr& shape, const
         return false;
     }
     
-    // 检查边是否属于形状
-    for (TopExp_Explorer exp(shape->GetOCCTShape(), TopAbs_EDGE); exp.More(); exp.Next()) {
-        if (exp.Current().IsSame(edge)) {
-            // 检查边是否有相邻面
-            std::vector<TopoDS_Face> faces = GetAdjacentFaces(shape, edge);
-            return faces.size() >= 2;
-        }
-    }
-    
-    return false;
+    // 边必须属于形状并且有两个相邻面，拓扑索引中查一次即可
+    return shape->GetTopologyIndex().GetAdjacentFaceCount(edge) >= 2;
 }
 
 bool FilletChamferOperations::IsValidEdgeForChamfer(const ShapePtr& shape, const TopoDS_Edge& edge) {
@@ -189,18 +250,8 @@ std::vector<TopoDS_Face> FilletChamferOperations::GetAdjacentFaces(const ShapePt
         return faces;
     }
     
-    TopTools_IndexedDataMapOfShapeListOfShape edgeFaceMap;
-    TopExp::MapShapesAndAncestors(shape->GetOCCTShape(), TopAbs_EDGE, TopAbs_FACE, edgeFaceMap);
-    
-    if (edgeFaceMap.Contains(edge)) {
-        const TopTools_ListOfShape& faceList = edgeFaceMap.FindFromKey(edge);
-        for (TopTools_ListIteratorOfListOfShape it(faceList); it.More(); it.Next()) {
-            TopoDS_Face face = TopoDS::Face(it.Value());
-            faces.push_back(face);
-        }
-    }
-    
-    return faces;
+    // 使用形状缓存的边→面邻接关系，不再每次重建整张映射表
+    return shape->GetTopologyIndex().GetAdjacentFaces(edge);
 }
 
 double FilletChamferOperations::GetSuggestedFilletRadius(const ShapePtr& shape, const TopoDS_Edge& edge) {
@@ -243,7 +294,7 @@ ShapePtr FilletChamferOperations::PerformFillet(const ShapePtr& shape, const std
         
         if (fillet.IsDone()) {
             TopoDS_Shape result = fillet.Shape();
-            return PostProcessResult(result);
+            return PostProcessResult(result, shape, fillet);
         }
     } catch (const Standard_Failure& e) {
         // 圆角操作失败
@@ -262,10 +313,7 @@ ShapePtr FilletChamferOperations::PerformChamfer(const ShapePtr& shape, const st
         
         for (const auto& edge : edges) {
             if (!edge.IsNull() && IsValidEdgeForChamfer(shape, edge)) {
-                std::vector<TopoDS_Face> faces = GetAdjacentFaces(shape, edge);
-                if (faces.size() >= 1) {
-                    chamfer.Add(distance, edge);
-                }
+                chamfer.Add(distance, edge);
             }
         }
         
@@ -273,7 +321,7 @@ ShapePtr FilletChamferOperations::PerformChamfer(const ShapePtr& shape, const st
         
         if (chamfer.IsDone()) {
             TopoDS_Shape result = chamfer.Shape();
-            return PostProcessResult(result);
+            return PostProcessResult(result, shape, chamfer);
         }
     } catch (const Standard_Failure& e) {
         // 倒角操作失败
@@ -282,18 +330,144 @@ ShapePtr FilletChamferOperations::PerformChamfer(const ShapePtr& shape, const st
     return nullptr;
 }
 
-ShapePtr FilletChamferOperations::PostProcessResult(const TopoDS_Shape& result) {
+std::vector<FilletChamferBodyResult> FilletChamferOperations::PerformBatch(const EdgesByShape& edgesByShape, double value,
+                                                                           bool isFillet, bool isolateFailures) {
+    std::vector<FilletChamferBodyResult> results;
+    results.reserve(edgesByShape.size());
+    for (const auto& shapeEdges : edgesByShape) {
+        FilletChamferBodyResult bodyResult;
+        bodyResult.original = shapeEdges.first;
+        bodyResult.edgeCount = shapeEdges.second.size();
+        results.push_back(bodyResult);
+    }
+    
+    // 不同实体上的圆角互不影响，每个实体一个任务；
+    // 每个任务只访问自己的Shape（包括它的拓扑索引缓存），无需加锁
+    std::vector<const std::vector<TopoDS_Edge>*> edgeLists;
+    edgeLists.reserve(edgesByShape.size());
+    for (const auto& shapeEdges : edgesByShape) {
+        edgeLists.push_back(&shapeEdges.second);
+    }
+    
+    OSD_Parallel::For(0, static_cast<int>(results.size()), [&](int i) {
+        FilletChamferBodyResult& bodyResult = results[i];
+        const std::vector<TopoDS_Edge>& edges = *edgeLists[i];
+        
+        if (!bodyResult.original || bodyResult.original->GetOCCTShape().IsNull() || edges.empty()) {
+            bodyResult.error = "No shape or edges";
+            return;
+        }
+        
+        try {
+            if (isFillet && isolateFailures) {
+                FilletBatchResult batch = CreateFilletIsolatingFailures(bodyResult.original, edges, value);
+                bodyResult.result = batch.result;
+                bodyResult.rejectedEdges = batch.rejectedEdges;
+            } else {
+                bodyResult.result = isFillet ? PerformFillet(bodyResult.original, edges, value)
+                                             : PerformChamfer(bodyResult.original, edges, value);
+            }
+            if (!bodyResult.result) {
+                bodyResult.error = isFillet ? "Fillet could not be built on the selected edges"
+                                            : "Chamfer could not be built on the selected edges";
+            }
+        } catch (const std::exception& e) {
+            bodyResult.error = e.what();
+        }
+    });
+    
+    return results;
+}
+
+ShapePtr FilletChamferOperations::TryBuildFillet(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                                 std::vector<TopoDS_Edge>* faultyEdges) {
+    try {
+        BRepFilletAPI_MakeFillet fillet(shape->GetOCCTShape());
+        for (const auto& edge : edges) {
+            fillet.Add(radius, edge);
+        }
+        
+        fillet.Build();
+        
+        if (fillet.IsDone()) {
+            // 结果验证不通过同样视为不可行
+            return PostProcessResult(fillet.Shape(), shape, fillet);
+        }
+        
+        // 收集构建器报告的故障轮廓上的所有边
+        if (faultyEdges) {
+            for (int i = 1; i <= fillet.NbFaultyContours(); i++) {
+                int contour = fillet.FaultyContour(i);
+                for (int j = 1; j <= fillet.NbEdges(contour); j++) {
+                    faultyEdges->push_back(fillet.Edge(contour, j));
+                }
+            }
+        }
+    } catch (const Standard_Failure& e) {
+        // 圆角操作失败
+    }
+    
+    return nullptr;
+}
+
+void FilletChamferOperations::BisectFilletEdges(const ShapePtr& shape, const std::vector<TopoDS_Edge>& edges, double radius,
+                                                FilletBatchResult& batch) {
+    if (edges.empty()) {
+        return;
+    }
+    
+    // 在已接受的边基础上尝试加入这一组
+    std::vector<TopoDS_Edge> trial = batch.appliedEdges;
+    trial.insert(trial.end(), edges.begin(), edges.end());
+    
+    batch.buildCount++;
+    ShapePtr result = TryBuildFillet(shape, trial, radius, nullptr);
+    if (result) {
+        batch.appliedEdges = trial;
+        batch.result = result;
+        return;
+    }
+    
+    if (edges.size() == 1) {
+        batch.rejectedEdges.push_back(edges.front());
+        return;
+    }
+    
+    size_t mid = edges.size() / 2;
+    BisectFilletEdges(shape, std::vector<TopoDS_Edge>(edges.begin(), edges.begin() + mid), radius, batch);
+    BisectFilletEdges(shape, std::vector<TopoDS_Edge>(edges.begin() + mid, edges.end()), radius, batch);
+}
+
+ShapePtr FilletChamferOperations::PostProcessResult(const TopoDS_Shape& result, const ShapePtr& original,
+                                                    BRepBuilderAPI_MakeShape& builder) {
     if (result.IsNull()) {
         return nullptr;
     }
     
+    ShapePtr resultShape = std::make_shared<Shape>(result);
+    
+    // Fast策略只检查圆角/倒角修改和生成的面，需要构建器的历史
+    TopTools_ListOfShape arguments;
+    Handle(BRepTools_History) history;
+    if (s_validationPolicy == ValidationPolicy::Fast && original) {
+        arguments.Append(original->GetOCCTShape());
+        history = new BRepTools_History(arguments, builder);
+    }
+    
     // 验证结果形状
-    BRepCheck_Analyzer analyzer(result);
-    if (!analyzer.IsValid()) {
+    if (!ShapeValidator::Validate(resultShape, s_validationPolicy, arguments, history)) {
         return nullptr;
     }
     
-    return std::make_shared<Shape>(result);
+    return resultShape;
+}
+
+void FilletChamferOperations::SetValidationPolicy(ValidationPolicy policy) {
+    s_validationPolicy = policy;
+}
+
+ValidationPolicy FilletChamferOperations::GetValidationPolicy() {
+    return s_validationPolicy;
 }
 
 bool FilletChamferOperations::AnalyzeEdge(const ShapePtr& shape, const TopoDS_Edge& edge, double& minRadius, double& maxRadius) {
@@ -7,18 +7,35 @@
 #include <TDataStd_Integer.hxx>
 #include <TNaming_Builder.hxx>
 #include <TNaming_NamedShape.hxx>
+#include <TNaming_Iterator.hxx>
+#include <TDF_AttributeIterator.hxx>
+#include <TDF_LabelList.hxx>
+#include <TDF_LabelMap.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 #include <BinDrivers.hxx>
 #include <BinXCAFDrivers.hxx>
 #include <XmlDrivers.hxx>
 #include <XmlXCAFDrivers.hxx>
 #include <Standard_GUID.hxx>
 #include <TCollection_ExtendedString.hxx>
+#include <algorithm>
 #include <iostream>
 
 namespace cad_core {
 
+namespace {
+
+// GUID of the per-parent "next free child tag" counter attribute
+const Standard_GUID& NextTagGUID() {
+    static const Standard_GUID guid("6b1f3c2e-9d4a-4e57-8c1b-2f7a9e0d5c31");
+    return guid;
+}
+
+} // namespace
+
 OCAFDocument::OCAFDocument() 
-    : m_isInitialized(false), m_inTransaction(false) {
+    : m_isInitialized(false), m_inTransaction(false), m_compactOnSave(true), m_transactionSerial(0) {
 }
 
 OCAFDocument::~OCAFDocument() {
@@ -85,6 +102,13 @@ void OCAFDocument::InitializeDocument() {
     
     // Initialize XCAFDoc tools
     m_shapeTool = XCAFDoc_DocumentTool::ShapeTool(m_document->Main());
+    
+    // Index the shapes of an opened document (empty for a new one)
+    RebuildIndex();
+    
+    // A freshly created or loaded document has no undo history
+    m_transactionSerial = 0;
+    m_deathSerials.clear();
 }
 
 bool OCAFDocument::OpenDocument(const std::string& filename) {
@@ -109,6 +133,10 @@ bool OCAFDocument::SaveDocument(const std::string& filename) {
             return false;
         }
         
+        if (m_compactOnSave) {
+            CompactDocument();
+        }
+        
         TCollection_ExtendedString path(filename.c_str());
         // Use the correct method for saving documents
         m_application->SaveAs(m_document, path);
@@ -141,6 +169,10 @@ TDF_Label OCAFDocument::AddShape(const ShapePtr& shape, const std::string& name)
             SetName(shapeLabel, "Shape");
         }
         
+        IndexLabel(shapeLabel);
+        if (m_inTransaction) {
+            m_transactionLabels.Add(shapeLabel);
+        }
         return shapeLabel;
     } catch (const Standard_Failure& e) {
         return TDF_Label();
@@ -153,6 +185,9 @@ bool OCAFDocument::RemoveShape(const TDF_Label& label) {
     }
     
     try {
+        // Drop the index entries while the label still holds the live shape
+        UnindexLabel(label);
+        
         // Use TNaming_Builder to properly record the deletion for undo/redo
         TNaming_Builder builder(label);
         Handle(TNaming_NamedShape) namedShape;
@@ -166,6 +201,11 @@ bool OCAFDocument::RemoveShape(const TDF_Label& label) {
         // Mark as deleted but keep TNaming for undo/redo
         TDataStd_Integer::Set(label, 0); // Mark as deleted
         
+        // Remember which transaction deleted it; compaction waits until it leaves the undo stack
+        if (label.Father() == m_shapesLabel) {
+            m_deathSerials[label.Tag()] = m_inTransaction ? m_transactionSerial + 1 : m_transactionSerial;
+        }
+        
         return true;
     } catch (const Standard_Failure& e) {
         return false;
@@ -210,6 +250,75 @@ std::vector<TDF_Label> OCAFDocument::GetAllShapes() const {
     return shapes;
 }
 
+TDF_Label OCAFDocument::FindLabelByName(const std::string& name) const {
+    auto it = m_nameIndex.find(name);
+    return it != m_nameIndex.end() ? it->second : TDF_Label();
+}
+
+TDF_Label OCAFDocument::FindLabelByShape(const TopoDS_Shape& shape) const {
+    if (shape.IsNull()) {
+        return TDF_Label();
+    }
+    
+    auto it = m_shapeIndex.find(shape.Oriented(TopAbs_FORWARD));
+    if (it == m_shapeIndex.end()) {
+        return TDF_Label();
+    }
+    
+    // Several labels may hold the same shape (an operand returned as a boolean result);
+    // take the oldest one, like the former child scan, and never one added in this transaction
+    TDF_Label found;
+    for (const TDF_Label& label : it->second) {
+        if (m_transactionLabels.Contains(label)) {
+            continue;
+        }
+        if (found.IsNull() || label.Tag() < found.Tag()) {
+            found = label;
+        }
+    }
+    return found;
+}
+
+CompactionStatistics OCAFDocument::CompactDocument() {
+    CompactionStatistics stats;
+    if (m_document.IsNull() || m_shapesLabel.IsNull() || m_inTransaction) {
+        return stats;
+    }
+    
+    // Deletions made in transactions newer than this can still be undone
+    int horizon = m_transactionSerial - m_document->GetAvailableUndos();
+    
+    try {
+        for (TDF_ChildIterator it(m_shapesLabel); it.More(); it.Next()) {
+            TDF_Label label = it.Value();
+            if (!IsDeadShapeLabel(label)) {
+                continue;
+            }
+            
+            // Labels dead since the document was loaded have no record and are always reclaimable
+            auto record = m_deathSerials.find(label.Tag());
+            if (record != m_deathSerials.end() && record->second > horizon) {
+                stats.pendingLabels++;
+                continue;
+            }
+            
+            stats.reclaimedBytes += EstimateLabelSize(label);
+            stats.reclaimedLabels++;
+            label.ForgetAllAttributes(Standard_True);
+            if (record != m_deathSerials.end()) {
+                m_deathSerials.erase(record);
+            }
+        }
+    } catch (const Standard_Failure& e) {
+        std::cout << "[OCAF] Compaction failed" << std::endl;
+    }
+    
+    std::cout << "[OCAF] Compaction reclaimed " << stats.reclaimedLabels << " labels (~"
+              << stats.reclaimedBytes << " bytes), " << stats.pendingLabels << " still undoable" << std::endl;
+    m_lastCompaction = stats;
+    return stats;
+}
+
 TDF_Label OCAFDocument::CreateFolder(const std::string& name, const TDF_Label& parent) {
     try {
         TDF_Label parentLabel = parent.IsNull() ? m_rootLabel : parent;
@@ -249,7 +358,17 @@ bool OCAFDocument::SetName(const TDF_Label& label, const std::string& name) {
     }
     
     try {
+        // Keep the name index in sync when a live shape is renamed
+        bool indexed = IsLiveShapeLabel(label);
+        if (indexed) {
+            UnindexLabel(label);
+        }
+        
         TDataStd_Name::Set(label, TCollection_ExtendedString(name.c_str()));
+        
+        if (indexed) {
+            IndexLabel(label);
+        }
         return true;
     } catch (const Standard_Failure& e) {
         return false;
@@ -337,7 +456,11 @@ bool OCAFDocument::Undo() {
     }
     
     try {
+        // The most recent undo delta lists every label the undo will touch
+        std::vector<ShapeLabelChange> changes = BeginDeltaChanges(m_document->GetUndos().Last());
         m_document->Undo();
+        m_transactionSerial--;
+        EndDeltaChanges(changes);
         return true;
     } catch (const Standard_Failure& e) {
         return false;
@@ -350,7 +473,10 @@ bool OCAFDocument::Redo() {
     }
     
     try {
+        std::vector<ShapeLabelChange> changes = BeginDeltaChanges(m_document->GetRedos().First());
         m_document->Redo();
+        m_transactionSerial++;
+        EndDeltaChanges(changes);
         return true;
     } catch (const Standard_Failure& e) {
         return false;
@@ -381,6 +507,7 @@ void OCAFDocument::StartTransaction(const std::string& name) {
     try {
         m_document->NewCommand();
         m_inTransaction = true;
+        m_transactionLabels.Clear();
         std::cout << "[OCAF] Transaction started: " << name << std::endl;
     } catch (const Standard_Failure& e) {
         m_inTransaction = false;
@@ -395,8 +522,12 @@ void OCAFDocument::CommitTransaction() {
     }
     
     try {
-        m_document->CommitCommand();
+        // An empty command is not added to the undo stack
+        if (m_document->CommitCommand()) {
+            m_transactionSerial++;
+        }
         m_inTransaction = false;
+        m_transactionLabels.Clear();
         std::cout << "[OCAF] Transaction committed. Available undos: " << m_document->GetAvailableUndos() << std::endl;
     } catch (const Standard_Failure& e) {
         m_inTransaction = false;
@@ -415,6 +546,10 @@ void OCAFDocument::AbortTransaction() {
     } catch (const Standard_Failure& e) {
         m_inTransaction = false;
     }
+    
+    // The rollback may have restored or dropped shapes added in this transaction
+    m_transactionLabels.Clear();
+    RebuildIndex();
 }
 
 TDF_Label OCAFDocument::GetRootLabel() const {
@@ -422,15 +557,185 @@ TDF_Label OCAFDocument::GetRootLabel() const {
 }
 
 TDF_Label OCAFDocument::GetNextAvailableLabel(const TDF_Label& parent) {
-    int tag = 1;
-    TDF_Label child = parent.FindChild(tag, Standard_False);
+    // The next free tag is stored as an attribute on the parent, so it is saved with
+    // the document and rolled back by undo together with the labels it handed out
+    Handle(TDataStd_Integer) counter;
+    if (!parent.FindAttribute(NextTagGUID(), counter)) {
+        // Documents saved without the counter: scan the children once
+        int maxTag = 0;
+        for (TDF_ChildIterator it(parent); it.More(); it.Next()) {
+            maxTag = std::max(maxTag, it.Value().Tag());
+        }
+        counter = TDataStd_Integer::Set(parent, NextTagGUID(), maxTag + 1);
+    }
     
-    while (!child.IsNull()) {
+    // Skip children created behind the counter's back (e.g. by the XCAF tools);
+    // empty labels left over from an undone addition are reused
+    int tag = counter->Get();
+    TDF_Label child = parent.FindChild(tag, Standard_False);
+    while (!child.IsNull() && child.HasAttribute()) {
         tag++;
         child = parent.FindChild(tag, Standard_False);
     }
     
+    counter->Set(tag + 1);
     return parent.FindChild(tag, Standard_True);
 }
 
+void OCAFDocument::RebuildIndex() {
+    m_nameIndex.clear();
+    m_shapeIndex.clear();
+    
+    if (m_shapesLabel.IsNull()) {
+        return;
+    }
+    
+    for (TDF_ChildIterator it(m_shapesLabel); it.More(); it.Next()) {
+        IndexLabel(it.Value());
+    }
+}
+
+void OCAFDocument::IndexLabel(const TDF_Label& label) {
+    if (!IsLiveShapeLabel(label)) {
+        return;
+    }
+    
+    Handle(TNaming_NamedShape) namedShape;
+    label.FindAttribute(TNaming_NamedShape::GetID(), namedShape);
+    std::vector<TDF_Label>& labels = m_shapeIndex[namedShape->Get().Oriented(TopAbs_FORWARD)];
+    if (std::find(labels.begin(), labels.end(), label) == labels.end()) {
+        labels.push_back(label);
+    }
+    
+    std::string name = GetName(label);
+    if (!name.empty()) {
+        m_nameIndex[name] = label;
+    }
+}
+
+void OCAFDocument::UnindexLabel(const TDF_Label& label) {
+    auto nameIt = m_nameIndex.find(GetName(label));
+    if (nameIt != m_nameIndex.end() && nameIt->second == label) {
+        m_nameIndex.erase(nameIt);
+    }
+    
+    Handle(TNaming_NamedShape) namedShape;
+    if (label.FindAttribute(TNaming_NamedShape::GetID(), namedShape) && !namedShape->Get().IsNull()) {
+        auto shapeIt = m_shapeIndex.find(namedShape->Get().Oriented(TopAbs_FORWARD));
+        if (shapeIt != m_shapeIndex.end()) {
+            std::vector<TDF_Label>& labels = shapeIt->second;
+            labels.erase(std::remove(labels.begin(), labels.end(), label), labels.end());
+            if (labels.empty()) {
+                m_shapeIndex.erase(shapeIt);
+            }
+        }
+    }
+}
+
+std::vector<ShapeLabelChange> OCAFDocument::BeginDeltaChanges(const Handle(TDF_Delta)& delta) {
+    std::vector<ShapeLabelChange> changes;
+    if (delta.IsNull()) {
+        return changes;
+    }
+    
+    TDF_LabelList labels;
+    delta->Labels(labels);
+    
+    TDF_LabelMap seen;
+    for (TDF_ListIteratorOfLabelList it(labels); it.More(); it.Next()) {
+        const TDF_Label& label = it.Value();
+        if (label.Father() != m_shapesLabel || !seen.Add(label)) {
+            continue;
+        }
+        
+        ShapeLabelChange change;
+        change.label = label;
+        change.oldShape = GetLiveShape(label);
+        UnindexLabel(label);
+        changes.push_back(change);
+    }
+    
+    return changes;
+}
+
+void OCAFDocument::EndDeltaChanges(std::vector<ShapeLabelChange>& changes) {
+    m_lastChanges.clear();
+    for (auto& change : changes) {
+        IndexLabel(change.label);
+        change.newShape = GetLiveShape(change.label);
+        
+        // Attribute-only changes (e.g. the deletion flag of an already dead label) are not reported
+        if (change.oldShape.IsNull() && change.newShape.IsNull()) {
+            continue;
+        }
+        if (!change.oldShape.IsNull() && change.oldShape.IsEqual(change.newShape)) {
+            continue;
+        }
+        m_lastChanges.push_back(change);
+    }
+}
+
+TopoDS_Shape OCAFDocument::GetLiveShape(const TDF_Label& label) const {
+    if (!IsLiveShapeLabel(label)) {
+        return TopoDS_Shape();
+    }
+    
+    Handle(TNaming_NamedShape) namedShape;
+    label.FindAttribute(TNaming_NamedShape::GetID(), namedShape);
+    return namedShape->Get();
+}
+
+bool OCAFDocument::IsDeadShapeLabel(const TDF_Label& label) const {
+    if (label.IsNull() || label.Father() != m_shapesLabel) {
+        return false;
+    }
+    
+    // RemoveShape leaves a NamedShape recording the deletion; labels emptied by undo have none
+    Handle(TNaming_NamedShape) namedShape;
+    if (!label.FindAttribute(TNaming_NamedShape::GetID(), namedShape)) {
+        return false;
+    }
+    return namedShape->Get().IsNull() || GetInteger(label) == 0;
+}
+
+size_t OCAFDocument::EstimateLabelSize(const TDF_Label& label) {
+    size_t bytes = 0;
+    for (TDF_AttributeIterator it(label); it.More(); it.Next()) {
+        bytes += it.Value()->DynamicType()->Size();
+        
+        // The deletion record still holds the old shape
+        Handle(TNaming_NamedShape) namedShape = Handle(TNaming_NamedShape)::DownCast(it.Value());
+        if (namedShape.IsNull()) {
+            continue;
+        }
+        for (TNaming_Iterator shapes(namedShape); shapes.More(); shapes.Next()) {
+            if (shapes.OldShape().IsNull()) {
+                continue;
+            }
+            // Same rough per-element cost as the boolean result cache
+            TopTools_IndexedMapOfShape faces, edges, vertices;
+            TopExp::MapShapes(shapes.OldShape(), TopAbs_FACE, faces);
+            TopExp::MapShapes(shapes.OldShape(), TopAbs_EDGE, edges);
+            TopExp::MapShapes(shapes.OldShape(), TopAbs_VERTEX, vertices);
+            bytes += static_cast<size_t>(faces.Extent()) * 1024
+                   + static_cast<size_t>(edges.Extent()) * 512
+                   + static_cast<size_t>(vertices.Extent()) * 128;
+        }
+    }
+    return bytes;
+}
+
+bool OCAFDocument::IsLiveShapeLabel(const TDF_Label& label) const {
+    if (label.IsNull() || label.Father() != m_shapesLabel) {
+        return false;
+    }
+    
+    // Removed shapes keep their label with a deleted NamedShape and the integer flag set to 0
+    Handle(TNaming_NamedShape) namedShape;
+    if (!label.FindAttribute(TNaming_NamedShape::GetID(), namedShape) || namedShape->Get().IsNull()) {
+        return false;
+    }
+    return GetInteger(label) != 0;
+}
+
 } // namespace cad_core
\ No newline at end of file
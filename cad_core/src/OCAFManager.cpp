@@ -1,6 +1,5 @@
 ﻿#include "cad_core/OCAFManager.h"
 #include <sstream>
-#include <algorithm>
 
 namespace cad_core {
 
@@ -32,6 +31,7 @@ bool OCAFManager::NewDocument() {
         return false;
     }
     
+    m_nameCounters.clear();
     return m_document->NewDocument();
 }
 
@@ -40,6 +40,7 @@ bool OCAFManager::OpenDocument(const std::string& filename) {
         return false;
     }
     
+    m_nameCounters.clear();
     return m_document->OpenDocument(filename);
 }
 
@@ -86,15 +87,12 @@ bool OCAFManager::RemoveShape(const ShapePtr& shape) {
     }
     
     // 查找对应此形状的标签
-    std::vector<TDF_Label> labels = m_document->GetAllShapes();
-    for (const auto& label : labels) {
-        ShapePtr labelShape = m_document->GetShape(label);
-        if (labelShape && labelShape->GetOCCTShape().IsSame(shape->GetOCCTShape())) {
-            return m_document->RemoveShape(label);
-        }
+    TDF_Label label = m_document->FindLabelByShape(shape->GetOCCTShape());
+    if (label.IsNull()) {
+        return false; // 未找到形状
     }
     
-    return false; // 未找到形状
+    return m_document->RemoveShape(label);
 }
 
 bool OCAFManager::ReplaceShape(const ShapePtr& oldShape, const ShapePtr& newShape) {
@@ -103,24 +101,21 @@ bool OCAFManager::ReplaceShape(const ShapePtr& oldShape, const ShapePtr& newShap
     }
     
     // 查找对应旧形状的标签
-    std::vector<TDF_Label> labels = m_document->GetAllShapes();
-    for (const auto& label : labels) {
-        ShapePtr labelShape = m_document->GetShape(label);
-        if (labelShape && labelShape->GetOCCTShape().IsSame(oldShape->GetOCCTShape())) {
-            // 获取原有的名称
-            std::string name = m_document->GetName(label);
-            
-            // 移除旧形状
-            if (m_document->RemoveShape(label)) {
-                // 添加新形状，使用相同的名称
-                TDF_Label newLabel = m_document->AddShape(newShape, name);
-                return !newLabel.IsNull();
-            }
-            return false;
-        }
+    TDF_Label label = m_document->FindLabelByShape(oldShape->GetOCCTShape());
+    if (label.IsNull()) {
+        return false; // 未找到旧形状
     }
     
-    return false; // 未找到旧形状
+    // 获取原有的名称
+    std::string name = m_document->GetName(label);
+    
+    // 移除旧形状
+    if (m_document->RemoveShape(label)) {
+        // 添加新形状，使用相同的名称
+        TDF_Label newLabel = m_document->AddShape(newShape, name);
+        return !newLabel.IsNull();
+    }
+    return false;
 }
 
 ShapePtr OCAFManager::GetShape(const std::string& name) const {
@@ -172,6 +167,14 @@ std::vector<ShapePtr> OCAFManager::GetAllShapes() const {
     return shapes;
 }
 
+CompactionStatistics OCAFManager::CompactDocument() {
+    if (!m_document) {
+        return CompactionStatistics();
+    }
+    
+    return m_document->CompactDocument();
+}
+
 bool OCAFManager::Undo() {
     if (!m_document) {
         return false;
@@ -233,33 +236,24 @@ TDF_Label OCAFManager::FindShapeByName(const std::string& name) const {
         return TDF_Label();
     }
     
-    std::vector<TDF_Label> labels = m_document->GetAllShapes();
-    for (const auto& label : labels) {
-        if (m_document->GetName(label) == name) {
-            return label;
-        }
-    }
-    
-    return TDF_Label();
+    return m_document->FindLabelByName(name);
 }
 
 std::string OCAFManager::GenerateUniqueName(const std::string& baseName) const {
-    std::vector<std::string> existingNames = GetAllShapeNames();
-    
     // 如果基础名称不存在，则使用它
-    if (std::find(existingNames.begin(), existingNames.end(), baseName) == existingNames.end()) {
+    if (FindShapeByName(baseName).IsNull()) {
         return baseName;
     }
     
-    // 否则，附加一个数字
-    int counter = 1;
+    // 否则，附加一个数字；从该名称上次用到的编号继续，避免每次都从1开始探测
+    int& counter = m_nameCounters[baseName];
     std::string uniqueName;
     do {
+        counter++;
         std::stringstream ss;
         ss << baseName << "_" << counter;
         uniqueName = ss.str();
-        counter++;
-    } while (std::find(existingNames.begin(), existingNames.end(), uniqueName) != existingNames.end());
+    } while (!FindShapeByName(uniqueName).IsNull());
     
     return uniqueName;
 }
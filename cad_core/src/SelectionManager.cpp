@@ -2,8 +2,13 @@
 #include <AIS_Selection.hxx>
 #include <SelectMgr_EntityOwner.hxx>
 #include <StdSelect_BRepOwner.hxx>
-#include <TopExp.hxx>
-#include <TopTools_IndexedMapOfShape.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <SelectMgr_SensitiveEntity.hxx>
+#include <Select3D_SensitiveEntity.hxx>
+#include <StdSelect_ViewerSelector3d.hxx>
+#include <TColgp_Array1OfPnt2d.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <algorithm>
 #include <Prs3d_Drawer.hxx>
 #include <Quantity_Color.hxx>
 
@@ -40,24 +45,8 @@ void SelectionManager::UpdateSelectionMode() {
     // 清除当前选择模式
     m_context->ClearCurrents(Standard_False);
     
-    // 禁用所有选择模式
-    m_context->Deactivate();
-    
-    // 激活对应的选择模式
-    switch (m_currentMode) {
-        case SelectionMode::Shape:
-            m_context->Activate(0); // 形状模式
-            break;
-        case SelectionMode::Face:
-            m_context->Activate(4); // 面模式
-            break;
-        case SelectionMode::Edge:
-            m_context->Activate(2); // 边模式
-            break;
-        case SelectionMode::Vertex:
-            m_context->Activate(1); // 顶点模式
-            break;
-    }
+    // 逐个形状切换激活模式，不做全局停用/激活
+    ActivateMode(m_currentMode);
     
     // 设置高亮颜色
     Quantity_Color highlightColor;
@@ -84,26 +73,43 @@ void SelectionManager::UpdateSelectionMode() {
     }
 }
 
+void SelectionManager::ActivateMode(SelectionMode mode) {
+    m_currentMode = mode;
+    if (m_context.IsNull()) return;
+    
+    for (const auto& entry : m_registeredShapes) {
+        ActivateSelection(entry.second.aisShape);
+    }
+}
+
+void SelectionManager::ActivateSelection(const Handle(AIS_Shape)& aisShape) {
+    if (m_context.IsNull() || aisShape.IsNull()) return;
+    
+    // 单模式并存：激活当前模式的同时停用其他模式，已计算的选择结构不会被释放
+    m_context->SetSelectionModeActive(aisShape, static_cast<int>(m_currentMode), Standard_True,
+                                      AIS_SelectionModesConcurrency_Single, Standard_False);
+}
+
 void SelectionManager::StartSelection(int x, int y) {
     if (m_context.IsNull() || m_view.IsNull()) return;
     
-    m_context->MoveTo(x, y, m_view, Standard_True);
+    m_context->MoveTo(x, y, m_view, Standard_False);
 }
 
 void SelectionManager::UpdateSelection(int x, int y) {
     if (m_context.IsNull() || m_view.IsNull()) return;
     
-    m_context->MoveTo(x, y, m_view, Standard_True);
+    m_context->MoveTo(x, y, m_view, Standard_False);
 }
 
 void SelectionManager::EndSelection(int x, int y) {
     if (m_context.IsNull() || m_view.IsNull()) return;
     
-    m_context->MoveTo(x, y, m_view, Standard_True);
-    m_context->Select(Standard_True);
+    m_context->MoveTo(x, y, m_view, Standard_False);
+    m_context->Select(Standard_False);
     
     // 为选中的对象启用高亮显示
-    m_context->HilightSelected(Standard_True);
+    m_context->HilightSelected(Standard_False);
     
     // 更新选择信息
     m_selectedItems.clear();
@@ -122,14 +128,14 @@ void SelectionManager::EndSelection(int x, int y) {
 void SelectionManager::StartMultiSelection(int x, int y) {
     if (m_context.IsNull() || m_view.IsNull()) return;
     
-    m_context->MoveTo(x, y, m_view, Standard_True);
+    m_context->MoveTo(x, y, m_view, Standard_False);
 }
 
 void SelectionManager::AddToSelection(int x, int y) {
     if (m_context.IsNull() || m_view.IsNull()) return;
     
-    m_context->MoveTo(x, y, m_view, Standard_True);
-    m_context->ShiftSelect(Standard_True);
+    m_context->MoveTo(x, y, m_view, Standard_False);
+    m_context->ShiftSelect(Standard_False);
     
     // 更新选择信息
     m_selectedItems.clear();
@@ -148,8 +154,8 @@ void SelectionManager::AddToSelection(int x, int y) {
 void SelectionManager::RemoveFromSelection(int x, int y) {
     if (m_context.IsNull() || m_view.IsNull()) return;
     
-    m_context->MoveTo(x, y, m_view, Standard_True);
-    m_context->ShiftSelect(Standard_True);
+    m_context->MoveTo(x, y, m_view, Standard_False);
+    m_context->ShiftSelect(Standard_False);
     
     // 更新选择信息
     m_selectedItems.clear();
@@ -165,6 +171,66 @@ void SelectionManager::RemoveFromSelection(int x, int y) {
     }
 }
 
+std::vector<SelectionInfo> SelectionManager::SelectInRectangle(int xMin, int yMin, int xMax, int yMax, bool addToSelection) {
+    if (m_context.IsNull() || m_view.IsNull()) return {};
+    
+    // 选择器只拾取当前激活模式的敏感实体，框内完全包含的才算选中
+    m_context->MainSelector()->Pick(std::min(xMin, xMax), std::min(yMin, yMax),
+                                    std::max(xMin, xMax), std::max(yMin, yMax), m_view);
+    return CollectPickedOwners(addToSelection);
+}
+
+std::vector<SelectionInfo> SelectionManager::SelectInPolygon(const std::vector<std::pair<int, int>>& points, bool addToSelection) {
+    if (m_context.IsNull() || m_view.IsNull() || points.size() < 3) return {};
+    
+    TColgp_Array1OfPnt2d polyline(1, static_cast<int>(points.size()));
+    for (size_t i = 0; i < points.size(); ++i) {
+        polyline.SetValue(static_cast<int>(i) + 1, gp_Pnt2d(points[i].first, points[i].second));
+    }
+    
+    m_context->MainSelector()->Pick(polyline, m_view);
+    return CollectPickedOwners(addToSelection);
+}
+
+std::vector<SelectionInfo> SelectionManager::CollectPickedOwners(bool addToSelection) {
+    if (!addToSelection) {
+        m_selectedItems.clear();
+    }
+    
+    // 已选子形状集合，保证追加时O(1)去重
+    TopTools_MapOfShape selected;
+    for (const auto& item : m_selectedItems) {
+        selected.Add(item.subShape.IsNull() && item.shape ? item.shape->GetOCCTShape() : item.subShape);
+    }
+    
+    std::vector<SelectionInfo> picked;
+    const Handle(StdSelect_ViewerSelector3d)& selector = m_context->MainSelector();
+    for (int rank = 1; rank <= selector->NbPicked(); ++rank) {
+        Handle(StdSelect_BRepOwner) owner = Handle(StdSelect_BRepOwner)::DownCast(selector->Picked(rank));
+        if (owner.IsNull() || !owner->HasShape()) continue;
+        
+        // 只接受已登记的形状，跳过高亮层、视图立方体等辅助对象
+        Handle(AIS_Shape) aisShape = Handle(AIS_Shape)::DownCast(owner->Selectable());
+        if (aisShape.IsNull()) continue;
+        auto registered = m_registeredShapes.find(aisShape.get());
+        if (registered == m_registeredShapes.end() || !registered->second.shape) continue;
+        
+        const TopoDS_Shape& subShape = owner->Shape();
+        if (!selected.Add(subShape)) continue;
+        
+        const ShapePtr& shape = registered->second.shape;
+        const TopAbs_ShapeEnum type = subShape.ShapeType();
+        if (type == TopAbs_FACE || type == TopAbs_EDGE || type == TopAbs_VERTEX) {
+            picked.emplace_back(shape, subShape, type, GetSubShapeIndex(shape, subShape, type));
+        } else {
+            picked.emplace_back(shape, TopoDS_Shape(), TopAbs_SHAPE, -1);
+        }
+    }
+    
+    m_selectedItems.insert(m_selectedItems.end(), picked.begin(), picked.end());
+    return picked;
+}
+
 std::vector<SelectionInfo> SelectionManager::GetSelectedShapes() const {
     std::vector<SelectionInfo> shapes;
     for (const auto& item : m_selectedItems) {
@@ -240,6 +306,49 @@ void SelectionManager::HighlightAll(bool highlight) {
     }
 }
 
+void SelectionManager::RegisterShape(const Handle(AIS_Shape)& aisShape, const ShapePtr& shape) {
+    if (aisShape.IsNull() || !shape) return;
+    
+    m_registeredShapes[aisShape.get()] = RegisteredShape{aisShape, shape};
+}
+
+void SelectionManager::UnregisterShape(const Handle(AIS_Shape)& aisShape) {
+    if (aisShape.IsNull()) return;
+    
+    m_registeredShapes.erase(aisShape.get());
+}
+
+void SelectionManager::ClearRegisteredShapes() {
+    m_registeredShapes.clear();
+}
+
+std::vector<SelectionMemoryInfo> SelectionManager::GetSelectionMemoryReport() const {
+    std::vector<SelectionMemoryInfo> report;
+    report.reserve(m_registeredShapes.size());
+    
+    for (const auto& entry : m_registeredShapes) {
+        SelectionMemoryInfo info;
+        info.shape = entry.second.shape;
+        
+        for (const Handle(SelectMgr_Selection)& selection : entry.second.aisShape->Selections()) {
+            if (selection.IsNull() || selection->IsEmpty()) continue;
+            
+            info.computedModes.push_back(selection->Mode());
+            for (const Handle(SelectMgr_SensitiveEntity)& entity : selection->Entities()) {
+                if (entity.IsNull() || entity->BaseSensitive().IsNull()) continue;
+                ++info.entityCount;
+                info.subElementCount += static_cast<size_t>(entity->BaseSensitive()->NbSubElements());
+            }
+        }
+        
+        // 粗略估计：每个敏感实体约256字节，每个子元素（三角形/线段/点）连同BVH节点约64字节
+        info.estimatedBytes = info.entityCount * 256 + info.subElementCount * 64;
+        report.push_back(std::move(info));
+    }
+    
+    return report;
+}
+
 void SelectionManager::EnableShapeSelection(bool enable) {
     if (m_context.IsNull()) return;
     
@@ -270,7 +379,7 @@ SelectionInfo SelectionManager::CreateSelectionInfo(const Handle(AIS_Shape)& ais
     if (aisShape.IsNull()) return info;
     
     TopoDS_Shape shape = aisShape->Shape();
-    info.shape = std::make_shared<Shape>(shape);
+    info.shape = ResolveShape(aisShape);
     
     // 根据当前选择模式确定子形状
     switch (m_currentMode) {
@@ -282,7 +391,7 @@ SelectionInfo SelectionManager::CreateSelectionInfo(const Handle(AIS_Shape)& ais
             
         case SelectionMode::Face:
             if (subShapeIndex >= 0) {
-                info.subShape = GetSubShape(shape, TopAbs_FACE, subShapeIndex);
+                info.subShape = GetSubShape(info.shape, TopAbs_FACE, subShapeIndex);
                 info.shapeType = TopAbs_FACE;
                 info.index = subShapeIndex;
             }
@@ -290,7 +399,7 @@ SelectionInfo SelectionManager::CreateSelectionInfo(const Handle(AIS_Shape)& ais
             
         case SelectionMode::Edge:
             if (subShapeIndex >= 0) {
-                info.subShape = GetSubShape(shape, TopAbs_EDGE, subShapeIndex);
+                info.subShape = GetSubShape(info.shape, TopAbs_EDGE, subShapeIndex);
                 info.shapeType = TopAbs_EDGE;
                 info.index = subShapeIndex;
             }
@@ -298,7 +407,7 @@ SelectionInfo SelectionManager::CreateSelectionInfo(const Handle(AIS_Shape)& ais
             
         case SelectionMode::Vertex:
             if (subShapeIndex >= 0) {
-                info.subShape = GetSubShape(shape, TopAbs_VERTEX, subShapeIndex);
+                info.subShape = GetSubShape(info.shape, TopAbs_VERTEX, subShapeIndex);
                 info.shapeType = TopAbs_VERTEX;
                 info.index = subShapeIndex;
             }
@@ -308,28 +417,31 @@ SelectionInfo SelectionManager::CreateSelectionInfo(const Handle(AIS_Shape)& ais
     return info;
 }
 
-TopoDS_Shape SelectionManager::GetSubShape(const TopoDS_Shape& shape, TopAbs_ShapeEnum type, int index) {
-    TopTools_IndexedMapOfShape subShapes;
-    TopExp::MapShapes(shape, type, subShapes);
-    
-    if (index >= 0 && index < subShapes.Extent()) {
-        return subShapes(index + 1); // TopTools使用基于1的索引
+ShapePtr SelectionManager::ResolveShape(const Handle(AIS_Shape)& aisShape) const {
+    auto it = m_registeredShapes.find(aisShape.get());
+    if (it != m_registeredShapes.end() && it->second.shape &&
+        it->second.shape->GetOCCTShape().IsEqual(aisShape->Shape())) {
+        return it->second.shape;
     }
     
-    return TopoDS_Shape();
+    // 未登记的对象只能临时包装，拓扑索引无法跨次拾取复用
+    return std::make_shared<Shape>(aisShape->Shape());
 }
 
-int SelectionManager::GetSubShapeIndex(const TopoDS_Shape& shape, const TopoDS_Shape& subShape, TopAbs_ShapeEnum type) {
-    TopTools_IndexedMapOfShape subShapes;
-    TopExp::MapShapes(shape, type, subShapes);
+TopoDS_Shape SelectionManager::GetSubShape(const ShapePtr& shape, TopAbs_ShapeEnum type, int index) {
+    if (!shape) {
+        return TopoDS_Shape();
+    }
     
-    for (int i = 1; i <= subShapes.Extent(); i++) {
-        if (subShapes(i).IsSame(subShape)) {
-            return i - 1; // 转换为基于0的索引
-        }
+    return shape->GetTopologyIndex().GetSubShape(type, index);
+}
+
+int SelectionManager::GetSubShapeIndex(const ShapePtr& shape, const TopoDS_Shape& subShape, TopAbs_ShapeEnum type) {
+    if (!shape) {
+        return -1;
     }
     
-    return -1;
+    return shape->GetTopologyIndex().GetSubShapeIndex(subShape, type);
 }
 
 } // namespace cad_core
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include "cad_core/Shape.h"
 #include <GProp_GProps.hxx>  // 几何属性计算 - OpenCASCADE的瑞士军刀
 #include <BRepGProp.hxx>     // 边界表示几何属性 - 专门处理实体几何
+#include <BRepBndLib.hxx>    // 包围盒计算
+#include <Standard_Failure.hxx>
+#include <chrono>
+#include <thread>
 
 namespace cad_core {
 
@@ -47,6 +51,16 @@ const TopoDS_Shape& Shape::GetOCCTShape() const {
  */
 void Shape::SetOCCTShape(const TopoDS_Shape& shape) {
     m_shape = shape;
+    
+    // 形状换了，缓存的包围盒也就作废了
+    m_boundingBox.SetVoid();
+    m_orientedBoundingBox.SetVoid();
+    m_hasBoundingBox = false;
+    m_hasOrientedBoundingBox = false;
+    m_properties = std::shared_future<ShapeProperties>();
+    m_topologyIndex.reset();
+    m_topologyQuery.reset();
+    m_validated = false;
     // TODO: 考虑添加变更通知机制，让依赖的对象知道形状变了
 }
 
@@ -61,8 +75,7 @@ bool Shape::IsValid() const {
 
 /**
  * 计算体积
- * 使用OpenCASCADE的几何属性计算功能
- * 注意：这里的"Mass"实际上是体积，OpenCASCADE的命名有时候很迷惑
+ * 从缓存的质量属性中取，第一次调用才真正计算
  * @return 体积值，如果形状无效则返回0
  */
 double Shape::Volume() const {
@@ -71,17 +84,7 @@ double Shape::Volume() const {
         return 0.0;
     }
     
-    // OpenCASCADE的几何属性计算器
-    GProp_GProps props;
-    
-    // 计算体积属性，BRepGProp就是专门干这个的
-    BRepGProp::VolumeProperties(m_shape, props);
-    
-    // Mass()实际返回的是体积，别被名字骗了
-    return props.Mass();
-    
-    // TODO: 添加异常处理，有些奇怪的形状可能会让计算崩溃
-    // TODO: 考虑缓存体积计算结果，避免重复计算
+    return GetProperties().volume;
 }
 
 /**
@@ -95,17 +98,203 @@ double Shape::Area() const {
         return 0.0;
     }
     
-    // 又是熟悉的几何属性计算器
-    GProp_GProps props;
+    return GetProperties().area;
+}
+
+/**
+ * 计算重心
+ * @return 重心坐标，空形状返回原点
+ */
+gp_Pnt Shape::Centroid() const {
+    if (!IsValid()) {
+        return gp_Pnt();
+    }
     
-    // 计算表面积属性
-    BRepGProp::SurfaceProperties(m_shape, props);
+    return GetProperties().centroid;
+}
+
+/**
+ * 计算惯性矩阵
+ * @return 惯性矩阵，空形状返回零矩阵
+ */
+gp_Mat Shape::Inertia() const {
+    if (!IsValid()) {
+        return gp_Mat();
+    }
+    
+    return GetProperties().inertia;
+}
+
+/**
+ * 获取质量属性
+ * 没算过就在当前线程算（deferred），后台正在算就等结果
+ * @return 缓存的质量属性
+ */
+const ShapeProperties& Shape::GetProperties() const {
+    if (!m_properties.valid()) {
+        m_properties = std::async(std::launch::deferred, &Shape::ComputeProperties,
+                                  m_shape, m_propertiesPrecision).share();
+    }
+    return m_properties.get();
+}
+
+/**
+ * 后台计算质量属性
+ * 用分离的线程+promise而不是std::async：async的future析构时会阻塞，
+ * 形状在计算途中被替换或销毁时界面就又卡住了
+ */
+void Shape::ComputePropertiesAsync() const {
+    if (m_properties.valid() || !IsValid()) {
+        return;
+    }
+    
+    auto promise = std::make_shared<std::promise<ShapeProperties>>();
+    m_properties = promise->get_future().share();
+    
+    TopoDS_Shape shape = m_shape;
+    double precision = m_propertiesPrecision;
+    std::thread([promise, shape, precision]() {
+        promise->set_value(ComputeProperties(shape, precision));
+    }).detach();
+}
+
+/**
+ * 质量属性是否已算好
+ * @return true表示读取不会阻塞
+ */
+bool Shape::ArePropertiesReady() const {
+    return m_properties.valid() &&
+           m_properties.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/**
+ * 设置计算精度
+ * 精度变了，之前的结果就不算数了
+ * @param precision 相对误差，0表示默认
+ */
+void Shape::SetPropertiesPrecision(double precision) {
+    precision = precision > 0.0 ? precision : 0.0;
+    if (precision != m_propertiesPrecision) {
+        m_propertiesPrecision = precision;
+        m_properties = std::shared_future<ShapeProperties>();
+    }
+}
+
+double Shape::GetPropertiesPrecision() const {
+    return m_propertiesPrecision;
+}
+
+/**
+ * 真正的计算
+ * 注意：这里的"Mass"实际上是体积/面积，OpenCASCADE的命名有时候很迷惑
+ * @param shape 要计算的形状
+ * @param precision 相对误差，0表示默认
+ * @return 质量属性
+ */
+ShapeProperties Shape::ComputeProperties(const TopoDS_Shape& shape, double precision) {
+    ShapeProperties result;
+    if (shape.IsNull()) {
+        return result;
+    }
     
-    // 这里的Mass()返回的才是真正的表面积
-    return props.Mass();
+    try {
+        GProp_GProps volumeProps;
+        GProp_GProps surfaceProps;
+        if (precision > 0.0) {
+            BRepGProp::VolumeProperties(shape, volumeProps, precision);
+            BRepGProp::SurfaceProperties(shape, surfaceProps, precision);
+        } else {
+            BRepGProp::VolumeProperties(shape, volumeProps);
+            BRepGProp::SurfaceProperties(shape, surfaceProps);
+        }
+        
+        result.volume = volumeProps.Mass();
+        result.area = surfaceProps.Mass();
+        
+        // 没有体积的形状（面、壳）就用表面的重心和惯性
+        const GProp_GProps& massProps = result.volume > 0.0 ? volumeProps : surfaceProps;
+        result.centroid = massProps.CentreOfMass();
+        result.inertia = massProps.MatrixOfInertia();
+    } catch (const Standard_Failure& e) {
+        // 奇怪的形状可能让计算崩溃，返回零值
+    }
     
-    // TODO: 对于线框模型，这个函数的行为可能不符合预期
-    // TODO: 考虑添加不同类型形状的特殊处理
+    return result;
+}
+
+/**
+ * 获取轴对齐包围盒
+ * 不使用三角网格：网格会"削掉"曲面的凸起部分，包围盒可能偏小，
+ * 而布尔运算的快速排除必须是保守的
+ * @return 缓存的包围盒
+ */
+const Bnd_Box& Shape::GetBoundingBox() const {
+    if (!m_hasBoundingBox) {
+        m_boundingBox.SetVoid();
+        if (IsValid()) {
+            BRepBndLib::Add(m_shape, m_boundingBox, Standard_False);
+        }
+        m_hasBoundingBox = true;
+    }
+    return m_boundingBox;
+}
+
+/**
+ * 获取有向包围盒
+ * 计算比轴对齐包围盒贵一些，所以只有真正用到时才算
+ * @return 缓存的有向包围盒
+ */
+const Bnd_OBB& Shape::GetOrientedBoundingBox() const {
+    if (!m_hasOrientedBoundingBox) {
+        m_orientedBoundingBox.SetVoid();
+        if (IsValid()) {
+            BRepBndLib::AddOBB(m_shape, m_orientedBoundingBox, Standard_False, Standard_False, Standard_True);
+        }
+        m_hasOrientedBoundingBox = true;
+    }
+    return m_orientedBoundingBox;
+}
+
+/**
+ * 获取拓扑索引
+ * 懒构建：只有真正要查拓扑的形状才付出这次遍历的代价
+ * @return 缓存的拓扑索引
+ */
+const TopologyIndex& Shape::GetTopologyIndex() const {
+    if (!m_topologyIndex) {
+        m_topologyIndex = std::make_shared<const TopologyIndex>(m_shape);
+    }
+    return *m_topologyIndex;
+}
+
+/**
+ * 获取拓扑查询引擎
+ * 分类要对每个面/边做一次几何适配，所以也是第一次查询时才构建
+ * @return 缓存的拓扑查询
+ */
+const TopologyQuery& Shape::GetTopologyQuery() const {
+    if (!m_topologyQuery) {
+        GetTopologyIndex();
+        m_topologyQuery = std::make_shared<const TopologyQuery>(m_topologyIndex);
+    }
+    return *m_topologyQuery;
+}
+
+/**
+ * 设置验证标记
+ * 由ShapeValidator在检查通过后调用
+ * @param validated 是否已验证
+ */
+void Shape::SetValidated(bool validated) {
+    m_validated = validated;
+}
+
+/**
+ * 查询验证标记
+ * @return true表示已经检查过且有效
+ */
+bool Shape::IsValidated() const {
+    return m_validated;
 }
 
 } // namespace cad_core
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "cad_core/ShapeValidator.h"
+#include <BRepCheck_Analyzer.hxx>
+#include <BRep_Builder.hxx>
+#include <TopExp.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <Standard_Failure.hxx>
+
+namespace cad_core {
+
+bool ShapeValidator::s_runParallel = true;
+
+bool ShapeValidator::Validate(const ShapePtr& result, ValidationPolicy policy,
+                              const TopTools_ListOfShape& arguments,
+                              const Handle(BRepTools_History)& history) {
+    if (!result || result->GetOCCTShape().IsNull()) {
+        return false;
+    }
+    
+    if (policy == ValidationPolicy::None || result->IsValidated()) {
+        return true;
+    }
+    
+    bool valid = false;
+    if (policy == ValidationPolicy::Fast && !history.IsNull() && !arguments.IsEmpty()) {
+        valid = CheckModifiedFaces(result->GetOCCTShape(), arguments, history);
+    } else {
+        valid = RunAnalyzer(result->GetOCCTShape());
+    }
+    
+    result->SetValidated(valid);
+    return valid;
+}
+
+bool ShapeValidator::CheckShape(const ShapePtr& shape) {
+    if (!shape || shape->GetOCCTShape().IsNull()) {
+        return false;
+    }
+    
+    if (shape->IsValidated()) {
+        return true;
+    }
+    
+    bool valid = RunAnalyzer(shape->GetOCCTShape());
+    shape->SetValidated(valid);
+    return valid;
+}
+
+void ShapeValidator::SetRunParallel(bool enabled) {
+    s_runParallel = enabled;
+}
+
+bool ShapeValidator::GetRunParallel() {
+    return s_runParallel;
+}
+
+bool ShapeValidator::CheckModifiedFaces(const TopoDS_Shape& result, const TopTools_ListOfShape& arguments,
+                                        const Handle(BRepTools_History)& history) {
+    TopTools_IndexedMapOfShape resultFaces;
+    TopExp::MapShapes(result, TopAbs_FACE, resultFaces);
+    
+    // 收集结果中由运算修改或新生成的面，未改动的输入面不再检查
+    BRep_Builder builder;
+    TopoDS_Compound modifiedFaces;
+    builder.MakeCompound(modifiedFaces);
+    TopTools_MapOfShape added;
+    bool hasModified = false;
+    
+    auto collect = [&](const TopTools_ListOfShape& images) {
+        for (TopTools_ListIteratorOfListOfShape it(images); it.More(); it.Next()) {
+            const TopoDS_Shape& image = it.Value();
+            if (image.ShapeType() == TopAbs_FACE && resultFaces.Contains(image) && added.Add(image)) {
+                builder.Add(modifiedFaces, image);
+                hasModified = true;
+            }
+        }
+    };
+    
+    for (TopTools_ListIteratorOfListOfShape argIt(arguments); argIt.More(); argIt.Next()) {
+        // 面可能被修改，边和顶点可能生成新面（如圆角面）
+        TopTools_IndexedMapOfShape subShapes;
+        TopExp::MapShapes(argIt.Value(), TopAbs_FACE, subShapes);
+        TopExp::MapShapes(argIt.Value(), TopAbs_EDGE, subShapes);
+        TopExp::MapShapes(argIt.Value(), TopAbs_VERTEX, subShapes);
+        
+        for (int i = 1; i <= subShapes.Extent(); i++) {
+            const TopoDS_Shape& subShape = subShapes(i);
+            collect(history->Modified(subShape));
+            collect(history->Generated(subShape));
+        }
+    }
+    
+    if (!hasModified) {
+        return true;
+    }
+    
+    return RunAnalyzer(modifiedFaces);
+}
+
+bool ShapeValidator::RunAnalyzer(const TopoDS_Shape& shape) {
+    try {
+        BRepCheck_Analyzer analyzer(shape, Standard_True, s_runParallel);
+        return analyzer.IsValid();
+    } catch (const Standard_Failure& e) {
+        return false;
+    }
+}
+
+} // namespace cad_core
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "cad_core/TopologyIndex.h"
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+
+namespace cad_core {
+
+TopologyIndex::TopologyIndex(const TopoDS_Shape& shape) {
+    if (shape.IsNull()) {
+        return;
+    }
+    
+    TopExp::MapShapes(shape, TopAbs_FACE, m_faces);
+    TopExp::MapShapes(shape, TopAbs_EDGE, m_edges);
+    TopExp::MapShapes(shape, TopAbs_VERTEX, m_vertices);
+    TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, m_edgeFaces);
+}
+
+const TopTools_IndexedMapOfShape* TopologyIndex::GetSubShapes(TopAbs_ShapeEnum type) const {
+    switch (type) {
+        case TopAbs_FACE:
+            return &m_faces;
+        case TopAbs_EDGE:
+            return &m_edges;
+        case TopAbs_VERTEX:
+            return &m_vertices;
+        default:
+            return nullptr;
+    }
+}
+
+TopoDS_Shape TopologyIndex::GetSubShape(TopAbs_ShapeEnum type, int index) const {
+    const TopTools_IndexedMapOfShape* subShapes = GetSubShapes(type);
+    if (subShapes && index >= 0 && index < subShapes->Extent()) {
+        return (*subShapes)(index + 1); // TopTools使用基于1的索引
+    }
+    
+    return TopoDS_Shape();
+}
+
+int TopologyIndex::GetSubShapeIndex(const TopoDS_Shape& subShape, TopAbs_ShapeEnum type) const {
+    const TopTools_IndexedMapOfShape* subShapes = GetSubShapes(type);
+    if (!subShapes || subShape.IsNull()) {
+        return -1;
+    }
+    
+    // FindIndex按IsSame比较，未找到时返回0
+    return subShapes->FindIndex(subShape) - 1;
+}
+
+bool TopologyIndex::Contains(const TopoDS_Shape& subShape) const {
+    const TopTools_IndexedMapOfShape* subShapes = subShape.IsNull() ? nullptr : GetSubShapes(subShape.ShapeType());
+    return subShapes && subShapes->Contains(subShape);
+}
+
+std::vector<TopoDS_Face> TopologyIndex::GetAdjacentFaces(const TopoDS_Edge& edge) const {
+    std::vector<TopoDS_Face> faces;
+    
+    const TopTools_ListOfShape* faceList = edge.IsNull() ? nullptr : m_edgeFaces.Seek(edge);
+    if (faceList) {
+        for (TopTools_ListIteratorOfListOfShape it(*faceList); it.More(); it.Next()) {
+            faces.push_back(TopoDS::Face(it.Value()));
+        }
+    }
+    
+    return faces;
+}
+
+int TopologyIndex::GetAdjacentFaceCount(const TopoDS_Edge& edge) const {
+    const TopTools_ListOfShape* faceList = edge.IsNull() ? nullptr : m_edgeFaces.Seek(edge);
+    return faceList ? faceList->Extent() : 0;
+}
+
+} // namespace cad_core
\ No newline at end of file
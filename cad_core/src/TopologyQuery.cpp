@@ -0,0 +1,260 @@
+#include "cad_core/TopologyQuery.h"
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <BRep_Tool.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <Standard_Failure.hxx>
+#include <gp_Pln.hxx>
+#include <gp_Cylinder.hxx>
+#include <gp_Cone.hxx>
+#include <gp_Sphere.hxx>
+#include <gp_Torus.hxx>
+#include <gp_Lin.hxx>
+#include <gp_Circ.hxx>
+#include <gp_Elips.hxx>
+#include <algorithm>
+
+namespace cad_core {
+
+TopologyQuery::TopologyQuery(std::shared_ptr<const TopologyIndex> index) : m_index(std::move(index)) {
+    if (!m_index) {
+        return;
+    }
+
+    const TopTools_IndexedMapOfShape& faces = m_index->GetFaces();
+    m_faceGeometry.reserve(faces.Extent());
+    for (int i = 1; i <= faces.Extent(); ++i) {
+        const int faceIndex = i - 1;
+        m_faceGeometry.push_back(ClassifyFace(TopoDS::Face(faces(i))));
+
+        const FaceGeometry& geometry = m_faceGeometry.back();
+        m_facesByType[geometry.type].push_back(faceIndex);
+        if (geometry.type == GeomAbs_Cylinder) {
+            m_cylinderFacesByRadius.emplace_back(geometry.radius, faceIndex);
+        }
+    }
+
+    const TopTools_IndexedMapOfShape& edges = m_index->GetEdges();
+    m_edgeGeometry.reserve(edges.Extent());
+    for (int i = 1; i <= edges.Extent(); ++i) {
+        const int edgeIndex = i - 1;
+        m_edgeGeometry.push_back(ClassifyEdge(TopoDS::Edge(edges(i))));
+
+        const EdgeGeometry& geometry = m_edgeGeometry.back();
+        if (geometry.degenerated) {
+            continue;
+        }
+        m_edgesByType[geometry.type].push_back(edgeIndex);
+        if (geometry.type == GeomAbs_Circle) {
+            m_circleEdgesByRadius.emplace_back(geometry.radius, edgeIndex);
+        }
+    }
+
+    std::sort(m_circleEdgesByRadius.begin(), m_circleEdgesByRadius.end());
+    std::sort(m_cylinderFacesByRadius.begin(), m_cylinderFacesByRadius.end());
+}
+
+FaceGeometry TopologyQuery::ClassifyFace(const TopoDS_Face& face) {
+    FaceGeometry geometry;
+
+    try {
+        // 不需要参数域裁剪，只取底层曲面
+        BRepAdaptor_Surface surface(face, Standard_False);
+        geometry.type = surface.GetType();
+
+        switch (geometry.type) {
+            case GeomAbs_Plane: {
+                const gp_Pln plane = surface.Plane();
+                gp_Dir normal = plane.Axis().Direction();
+                // 左手坐标系的平面，D1U×D1V与主方向相反
+                if (!plane.Direct()) {
+                    normal.Reverse();
+                }
+                if (face.Orientation() == TopAbs_REVERSED) {
+                    normal.Reverse();
+                }
+                geometry.axis = gp_Ax1(plane.Location(), normal);
+                break;
+            }
+            case GeomAbs_Cylinder:
+                geometry.axis = surface.Cylinder().Axis();
+                geometry.radius = surface.Cylinder().Radius();
+                break;
+            case GeomAbs_Cone:
+                geometry.axis = surface.Cone().Axis();
+                geometry.radius = surface.Cone().RefRadius();
+                geometry.minorRadius = surface.Cone().SemiAngle();
+                break;
+            case GeomAbs_Sphere:
+                geometry.axis = surface.Sphere().Position().Axis();
+                geometry.radius = surface.Sphere().Radius();
+                break;
+            case GeomAbs_Torus:
+                geometry.axis = surface.Torus().Axis();
+                geometry.radius = surface.Torus().MajorRadius();
+                geometry.minorRadius = surface.Torus().MinorRadius();
+                break;
+            default:
+                break;
+        }
+    } catch (const Standard_Failure&) {
+        geometry.type = GeomAbs_OtherSurface;
+    }
+
+    return geometry;
+}
+
+EdgeGeometry TopologyQuery::ClassifyEdge(const TopoDS_Edge& edge) {
+    EdgeGeometry geometry;
+
+    if (BRep_Tool::Degenerated(edge)) {
+        geometry.degenerated = true;
+        return geometry;
+    }
+
+    try {
+        BRepAdaptor_Curve curve(edge);
+        geometry.type = curve.GetType();
+
+        switch (geometry.type) {
+            case GeomAbs_Line:
+                geometry.axis = curve.Line().Position();
+                break;
+            case GeomAbs_Circle:
+                geometry.axis = curve.Circle().Axis();
+                geometry.radius = curve.Circle().Radius();
+                break;
+            case GeomAbs_Ellipse:
+                geometry.axis = curve.Ellipse().Axis();
+                geometry.radius = curve.Ellipse().MajorRadius();
+                geometry.minorRadius = curve.Ellipse().MinorRadius();
+                break;
+            default:
+                break;
+        }
+    } catch (const Standard_Failure&) {
+        geometry.type = GeomAbs_OtherCurve;
+    }
+
+    return geometry;
+}
+
+const std::vector<int>& TopologyQuery::FindFaces(GeomAbs_SurfaceType type) const {
+    static const std::vector<int> empty;
+    auto it = m_facesByType.find(type);
+    return it != m_facesByType.end() ? it->second : empty;
+}
+
+const std::vector<int>& TopologyQuery::FindEdges(GeomAbs_CurveType type) const {
+    static const std::vector<int> empty;
+    auto it = m_edgesByType.find(type);
+    return it != m_edgesByType.end() ? it->second : empty;
+}
+
+std::vector<int> TopologyQuery::FindInRadiusRange(const std::vector<std::pair<double, int>>& sorted,
+                                                  double radius, double tolerance) {
+    std::vector<int> result;
+
+    auto first = std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(radius - tolerance, -1));
+    for (auto it = first; it != sorted.end() && it->first <= radius + tolerance; ++it) {
+        result.push_back(it->second);
+    }
+
+    // 返回按子形状编号排序，与其他查询一致
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<int> TopologyQuery::FindCircularEdges(double radius, double tolerance) const {
+    return FindInRadiusRange(m_circleEdgesByRadius, radius, tolerance);
+}
+
+std::vector<int> TopologyQuery::FindCylindricalFaces(double radius, double tolerance) const {
+    return FindInRadiusRange(m_cylinderFacesByRadius, radius, tolerance);
+}
+
+std::vector<int> TopologyQuery::FindPlanarFaces(const gp_Dir& normal, double angularTolerance) const {
+    std::vector<int> result;
+    for (int faceIndex : FindFaces(GeomAbs_Plane)) {
+        if (m_faceGeometry[faceIndex].axis.Direction().IsEqual(normal, angularTolerance)) {
+            result.push_back(faceIndex);
+        }
+    }
+    return result;
+}
+
+std::vector<int> TopologyQuery::FindLinearEdges(const gp_Dir& direction, double angularTolerance) const {
+    std::vector<int> result;
+    for (int edgeIndex : FindEdges(GeomAbs_Line)) {
+        if (m_edgeGeometry[edgeIndex].axis.Direction().IsParallel(direction, angularTolerance)) {
+            result.push_back(edgeIndex);
+        }
+    }
+    return result;
+}
+
+std::vector<int> TopologyQuery::FindFaces(const std::function<bool(const FaceGeometry&)>& predicate) const {
+    std::vector<int> result;
+    for (size_t i = 0; i < m_faceGeometry.size(); ++i) {
+        if (predicate(m_faceGeometry[i])) {
+            result.push_back(static_cast<int>(i));
+        }
+    }
+    return result;
+}
+
+std::vector<int> TopologyQuery::FindEdges(const std::function<bool(const EdgeGeometry&)>& predicate) const {
+    std::vector<int> result;
+    for (size_t i = 0; i < m_edgeGeometry.size(); ++i) {
+        if (!m_edgeGeometry[i].degenerated && predicate(m_edgeGeometry[i])) {
+            result.push_back(static_cast<int>(i));
+        }
+    }
+    return result;
+}
+
+std::vector<int> TopologyQuery::GetEdgesOfFaces(const std::vector<int>& faceIndices) const {
+    std::vector<int> result;
+    std::vector<bool> visited(m_edgeGeometry.size(), false);
+
+    for (int faceIndex : faceIndices) {
+        const TopoDS_Shape face = m_index->GetSubShape(TopAbs_FACE, faceIndex);
+        if (face.IsNull()) continue;
+
+        for (TopExp_Explorer exp(face, TopAbs_EDGE); exp.More(); exp.Next()) {
+            const int edgeIndex = m_index->GetSubShapeIndex(exp.Current(), TopAbs_EDGE);
+            if (edgeIndex < 0 || visited[edgeIndex] || m_edgeGeometry[edgeIndex].degenerated) continue;
+            visited[edgeIndex] = true;
+            result.push_back(edgeIndex);
+        }
+    }
+
+    return result;
+}
+
+std::vector<TopoDS_Edge> TopologyQuery::GetEdges(const std::vector<int>& edgeIndices) const {
+    std::vector<TopoDS_Edge> edges;
+    edges.reserve(edgeIndices.size());
+    for (int edgeIndex : edgeIndices) {
+        const TopoDS_Shape edge = m_index->GetSubShape(TopAbs_EDGE, edgeIndex);
+        if (!edge.IsNull()) {
+            edges.push_back(TopoDS::Edge(edge));
+        }
+    }
+    return edges;
+}
+
+std::vector<TopoDS_Face> TopologyQuery::GetFaces(const std::vector<int>& faceIndices) const {
+    std::vector<TopoDS_Face> faces;
+    faces.reserve(faceIndices.size());
+    for (int faceIndex : faceIndices) {
+        const TopoDS_Shape face = m_index->GetSubShape(TopAbs_FACE, faceIndex);
+        if (!face.IsNull()) {
+            faces.push_back(TopoDS::Face(face));
+        }
+    }
+    return faces;
+}
+
+} // namespace cad_core
\ No newline at end of file
@@ -1,5 +1,9 @@
 ﻿#include "cad_core/TransformCommand.h"
 #include <BRepBuilderAPI_Transform.hxx>
+#include <BRepBuilderAPI_GTransform.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp_GTrsf.hxx>
+#include <Standard_Failure.hxx>
 #include <gp_Vec.hxx>
 #include <gp_Ax1.hxx>
 #include <gp_Pnt.hxx>
@@ -36,20 +40,20 @@ bool TransformCommand::Execute() {
             }
             
             // 应用变换
-            BRepBuilderAPI_Transform transformer(shape->GetOCCTShape(), transformation);
-            
-            if (!transformer.IsDone()) {
+            auto transformedShape = TransformShape(shape, transformation);
+            if (!transformedShape) {
                 return false;
             }
             
-            // 创建变换后的形状
-            auto transformedShape = std::make_shared<Shape>(transformer.Shape());
             m_transformedShapes.push_back(transformedShape);
         }
         
         m_executed = true;
         return true;
     }
+    catch (const Standard_Failure& e) {
+        return false;
+    }
     catch (const std::exception& e) {
         return false;
     }
@@ -91,13 +95,15 @@ std::vector<ShapePtr> TransformCommand::GetTransformedShapes() const {
                     continue;
                 }
                 
-                BRepBuilderAPI_Transform transformer(shape->GetOCCTShape(), transformation);
-                if (transformer.IsDone()) {
-                    auto previewShape = std::make_shared<Shape>(transformer.Shape());
+                auto previewShape = TransformShape(shape, transformation);
+                if (previewShape) {
                     previewShapes.push_back(previewShape);
                 }
             }
         }
+        catch (const Standard_Failure& e) {
+            // 返回空vector如果变换失败
+        }
         catch (const std::exception& e) {
             // 返回空vector如果变换失败
         }
@@ -108,6 +114,13 @@ std::vector<ShapePtr> TransformCommand::GetTransformedShapes() const {
     return m_transformedShapes;
 }
 
+ShapePtr TransformCommand::TransformShape(const ShapePtr& shape, const gp_Trsf& transformation) const {
+    // 平移和旋转只是换个位置：新形状与原形状共享TShape，
+    // 曲面、曲线和已有的三角网格都原样保留，显示时不需要重新剖分
+    TopoDS_Shape moved = shape->GetOCCTShape().Moved(TopLoc_Location(transformation));
+    return std::make_shared<Shape>(moved);
+}
+
 // =============================================================================
 // TranslateCommand 实现
 // =============================================================================
@@ -242,8 +255,8 @@ gp_Trsf ScaleCommand::CreateTransformation() const {
         gp_Vec translation(-m_centerPoint.X(), -m_centerPoint.Y(), -m_centerPoint.Z());
         translateToOrigin.SetTranslation(translation);
         
-        // OpenCASCADE不直接支持非均匀缩放，需要使用矩阵变换
-        // 这里简化为均匀缩放，实际应用中可能需要更复杂的处理
+        // gp_Trsf不能表达非均匀缩放，这里只是近似的均匀变换，
+        // 实际的几何由TransformShape通过gp_GTrsf生成
         scale.SetScale(gp_Pnt(0, 0, 0), m_scaleX);
         
         gp_Vec translationBack(m_centerPoint.X(), m_centerPoint.Y(), m_centerPoint.Z());
@@ -260,4 +273,30 @@ const char* ScaleCommand::GetTypeName() const {
     return "缩放";
 }
 
+ShapePtr ScaleCommand::TransformShape(const ShapePtr& shape, const gp_Trsf& transformation) const {
+    if (m_isUniform) {
+        // 均匀缩放由BRepBuilderAPI_Transform修改几何
+        BRepBuilderAPI_Transform transformer(shape->GetOCCTShape(), transformation);
+        if (!transformer.IsDone()) {
+            return nullptr;
+        }
+        return std::make_shared<Shape>(transformer.Shape());
+    }
+    
+    // 非均匀缩放：x' = c + s * (x - c)，各轴系数不同，只能用一般仿射变换
+    gp_GTrsf scale;
+    scale.SetValue(1, 1, m_scaleX);
+    scale.SetValue(2, 2, m_scaleY);
+    scale.SetValue(3, 3, m_scaleZ);
+    scale.SetTranslationPart(gp_XYZ(m_centerPoint.X() * (1.0 - m_scaleX),
+                                    m_centerPoint.Y() * (1.0 - m_scaleY),
+                                    m_centerPoint.Z() * (1.0 - m_scaleZ)));
+    
+    BRepBuilderAPI_GTransform transformer(shape->GetOCCTShape(), scale, Standard_True);
+    if (!transformer.IsDone()) {
+        return nullptr;
+    }
+    return std::make_shared<Shape>(transformer.Shape());
+}
+
 } // namespace cad_core
\ No newline at end of file
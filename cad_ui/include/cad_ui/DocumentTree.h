@@ -19,6 +19,8 @@ public:
 
     void AddShape(const cad_core::ShapePtr& shape);
     void RemoveShape(const cad_core::ShapePtr& shape);
+    // 按OCCT形状移除第一个匹配的条目（忽略朝向）
+    void RemoveShape(const TopoDS_Shape& shape);
     void AddFeature(const cad_feature::FeaturePtr& feature);
     void RemoveFeature(const cad_feature::FeaturePtr& feature);
     void Clear();
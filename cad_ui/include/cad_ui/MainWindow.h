@@ -123,6 +123,8 @@ private slots:
     void OnShowAxes();
     void OnDarkTheme();
     void OnLightTheme();
+    void OnCompactDocument();
+    void OnSelectEdgesByRadius();
     
     void OnAbout();
     void OnAboutQt();
@@ -230,6 +232,7 @@ private:
     void UpdateWindowTitle();
     void UpdateActions();
     void RefreshUIFromOCAF();  // Refresh UI from OCAF document state
+    void SyncUIWithOCAFChanges();  // Apply only the shapes changed by the last undo/redo
     
     bool SaveChanges();
     void SetDocumentModified(bool modified);
@@ -298,6 +301,8 @@ private:
     QAction* m_showAxesAction;
     QAction* m_darkThemeAction;
     QAction* m_lightThemeAction;
+    QAction* m_compactDocumentAction;
+    QAction* m_selectEdgesByRadiusAction;
     
     QAction* m_aboutAction;
     QAction* m_aboutQtAction;
@@ -8,6 +8,7 @@
 #include <QDoubleSpinBox>
 #include <QGroupBox>
 #include <QScrollArea>
+#include <QTimer>
 #include "cad_core/Shape.h"
 #include "cad_feature/Feature.h"
 
@@ -32,10 +33,12 @@ private:
     
     cad_core::ShapePtr m_currentShape;
     cad_feature::FeaturePtr m_currentFeature;
+    QTimer* m_propertiesTimer;
     
     void CreateShapeProperties();
     void CreateFeatureProperties();
     void ClearProperties();
+    void OnPropertiesTimer();
     
     void AddProperty(const QString& name, const QString& value);
     void AddProperty(const QString& name, double value);
@@ -6,18 +6,27 @@
 #include <QKeyEvent>
 #include <QResizeEvent>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QPolygon>
+#include <QThreadPool>
+#include <atomic>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #include <Geom_Plane.hxx>
 #include <Geom_Line.hxx>
 #include <Geom_Surface.hxx>
+#include <gp_Trsf.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
 
 #include <V3d_View.hxx>
 #include <V3d_Viewer.hxx>
 #include <AIS_InteractiveContext.hxx>
 #include <AIS_Shape.hxx>
 #include <AIS_ViewController.hxx>
+#include <AIS_RubberBand.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
 
 #include "cad_core/Shape.h"
@@ -31,7 +40,7 @@ class QtOccView : public QWidget,protected AIS_ViewController {
 
 public:
     explicit QtOccView(QWidget* parent = nullptr);
-    ~QtOccView() = default;
+    ~QtOccView();
 
     // 视图器初始化
     bool InitViewer();
@@ -50,8 +59,43 @@ public:
     // 形状显示
     void DisplayShape(const cad_core::ShapePtr& shape);
     void RemoveShape(const cad_core::ShapePtr& shape);
+    // 批量显示/移除：中间不重绘，最后只做一次FitAll和Redraw
+    void DisplayShapes(const std::vector<cad_core::ShapePtr>& shapes);
+    void RemoveShapes(const std::vector<cad_core::ShapePtr>& shapes);
     void ClearShapes();
     void RedrawAll();
+    
+    // 帧调度：重绘请求合并为每16ms最多一次；只改高亮时用立即层重绘
+    struct RedrawStatistics {
+        quint64 requested = 0;
+        quint64 immediateRequested = 0;
+        quint64 executed = 0;
+        quint64 immediateExecuted = 0;
+    };
+    void RequestRedraw();
+    void RequestImmediateRedraw();
+    RedrawStatistics GetRedrawStatistics() const;
+    void ResetRedrawStatistics();
+    
+    // 按OCCT形状查找已显示的ShapePtr（忽略朝向），未显示返回nullptr；
+    // 多个标签持有同一形状时各有自己的ShapePtr，FindDisplayedShapes按显示顺序全部返回
+    cad_core::ShapePtr FindDisplayedShape(const TopoDS_Shape& shape) const;
+    const std::vector<cad_core::ShapePtr>& FindDisplayedShapes(const TopoDS_Shape& shape) const;
+    
+    // 显示对象缓存：移除的形状只是隐藏，连同网格和选择结构一起保留，
+    // 再次显示同一TShape+Location（撤销/重做）时直接复用
+    void SetPresentationCacheBudget(size_t bytes, int maxAgeMs);
+    void ClearPresentationCache();
+    size_t GetPresentationCacheUsage() const { return m_presentationCacheUsage; }
+    
+    // 后台剖分：面数不少于阈值且尚未剖分的形状先显示包围盒占位，
+    // 在线程池中并行剖分完成后再换成真正的显示对象；阈值<=0时全部同步显示
+    void SetBackgroundMeshThreshold(int faceCount) { m_backgroundMeshThreshold = faceCount; }
+    int GetPendingMeshCount() const { return static_cast<int>(m_meshJobs.size()); }
+    
+    // 变换预览：在已有显示对象上设置局部变换并半透明显示，不创建新形状也不重新剖分
+    void SetPreviewTransformation(const std::vector<cad_core::ShapePtr>& shapes, const gp_Trsf& transformation);
+    void ClearPreviewTransformation();
     virtual QPaintEngine* paintEngine() const;
     
     // 背景和外观
@@ -64,10 +108,17 @@ public:
     void ClearSelection();
     void SelectShape(const cad_core::ShapePtr& shape);
     
+    // 区域选择（当前模式）：Shift+左键拖动框选，Ctrl+Shift+左键拖动套索；
+    // 拾取结果一次性提交到高亮层，返回新选中的数量
+    int SelectInRectangle(const QRect& rect);
+    int SelectInPolygon(const QPolygon& polygon);
+    
     // 用于操作的边选择
     void ClearEdgeSelection();
     std::vector<TopoDS_Edge> GetSelectedTopoEdges() const { return m_selectedEdges; }
     std::map<cad_core::ShapePtr, std::vector<TopoDS_Edge>> GetSelectedEdgesByShape() const;
+    // 把一组边（如拓扑查询结果）一次性加入边选择集合，返回新加入的数量
+    int AddEdgesToSelection(const cad_core::ShapePtr& shape, const std::vector<TopoDS_Edge>& edges);
     void HighlightEdge(const TopoDS_Edge& edge);
     void HighlightVertex(const TopoDS_Vertex& vertex);
     void HighlightFace(const TopoDS_Face& face);
@@ -140,12 +191,49 @@ private:
     bool m_isInitialized;
     
     QTimer* m_redrawTimer;
+    QElapsedTimer m_frameClock;
+    bool m_fullRedrawPending;
+    bool m_immediateRedrawPending;
+    RedrawStatistics m_redrawStats;
+    static constexpr int kFrameIntervalMs = 16;
     
     // 选择管理器
     std::unique_ptr<cad_core::SelectionManager> m_selectionManager;
     
     // 用于选择同步的形状映射
     std::map<cad_core::ShapePtr, Handle(AIS_Shape)> m_shapeToAIS;
+    std::unordered_map<TopoDS_Shape, std::vector<cad_core::ShapePtr>> m_displayedShapes;
+    std::unordered_map<const AIS_InteractiveObject*, cad_core::ShapePtr> m_aisToShape;  // m_shapeToAIS的反向索引
+    
+    // 已隐藏、等待复用的显示对象
+    struct CachedPresentation {
+        Handle(AIS_Shape) aisShape;
+        qint64 erasedAt;
+        size_t size;
+    };
+    std::unordered_map<TopoDS_Shape, CachedPresentation> m_presentationCache;
+    size_t m_presentationCacheUsage;
+    size_t m_presentationCacheBudget;
+    int m_presentationCacheMaxAge;
+    QElapsedTimer m_presentationClock;
+    QTimer* m_presentationCacheTimer;
+    
+    // 后台剖分任务，移除形状时置取消标志，剖分线程会尽快退出。
+    // 工作线程只剖分拓扑副本（TFace可能被其他Shape共享），完成后由界面线程把网格挂回原形状
+    struct MeshJob {
+        cad_core::ShapePtr shape;
+        Handle(AIS_Shape) placeholder;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        TopoDS_Shape meshCopy;
+        double deflection;
+    };
+    std::unordered_map<quint64, MeshJob> m_meshJobs;
+    quint64 m_nextMeshJobId;
+    int m_backgroundMeshThreshold;
+    QThreadPool m_meshPool;
+    
+    // 正在做变换预览的显示对象
+    std::vector<Handle(AIS_Shape)> m_previewObjects;
     
     // 当前选择状态（单选模式）
     cad_core::ShapePtr m_currentSelectedShape;
@@ -153,16 +241,19 @@ private:
     
     // 用于倒角/倒圆等操作的边选择状态
     std::vector<TopoDS_Edge> m_selectedEdges;
-    std::vector<Handle(AIS_InteractiveObject)> m_highlightedEdges;
     std::vector<cad_core::ShapePtr> m_edgeParentShapes;  // 跟踪每个边的父形状（与m_selectedEdges索引相同）
+    TopTools_MapOfShape m_selectedEdgeSet;  // 与m_selectedEdges内容相同，用于O(1)去重
     
-    // 用于点选择的高亮状态
-    std::vector<TopoDS_Vertex> m_selectedVertices;
-    std::vector<Handle(AIS_InteractiveObject)> m_highlightedVertices;
-    
-    // 用于面选择的高亮状态
-    std::vector<TopoDS_Face> m_selectedFaces;
-    std::vector<Handle(AIS_InteractiveObject)> m_highlightedFaces;
+    // 高亮覆盖层：每个集合合并成一个复合体、一个显示对象，
+    // 修改只置脏标志，在下一帧绘制前统一重建一次
+    struct HighlightOverlay {
+        TopTools_IndexedMapOfShape shapes;
+        Handle(AIS_Shape) aisShape;
+        bool dirty = false;
+    };
+    HighlightOverlay m_edgeHighlight;
+    HighlightOverlay m_vertexHighlight;  // 也是点选择集合
+    HighlightOverlay m_faceHighlight;    // 也是面选择集合
     
     // 草图模式
     std::unique_ptr<class SketchMode> m_sketchMode;
@@ -170,12 +261,55 @@ private:
     // 当前选择模式
     int m_currentSelectionMode;
     
+    // 进行中的区域选择及其橡皮筋显示
+    enum class AreaSelection { None, Rectangle, Lasso };
+    AreaSelection m_areaSelection;
+    QPoint m_areaStart;
+    QPolygon m_lassoPoints;
+    Handle(AIS_RubberBand) m_rubberBand;
+    
     void InitializeOCC();
     void RedrawView();
+    void ScheduleFrame();
     void HandleSelection(const QPoint& point);
     
+    // 显示/移除单个形状但不重绘，供单个和批量接口共用
+    Handle(AIS_Shape) DisplayShapeNoUpdate(const cad_core::ShapePtr& shape);
+    void RemoveShapeNoUpdate(const cad_core::ShapePtr& shape);
+    void ActivateSelectionModes(const Handle(AIS_Shape)& aisShape);
+    cad_core::ShapePtr FindShapeForAIS(const Handle(AIS_InteractiveObject)& aisObject) const;
+    
+    // 高亮覆盖层辅助
+    bool AddHighlight(HighlightOverlay& overlay, const TopoDS_Shape& shape);
+    void ClearHighlight(HighlightOverlay& overlay);
+    void RebuildHighlight(HighlightOverlay& overlay);
+    void FlushHighlights();
+    
+    // 区域选择辅助
+    void UpdateRubberBand(const QPoint& pos);
+    void HideRubberBand();
+    int CommitAreaSelection(const std::vector<cad_core::SelectionInfo>& picked);
+    void RegisterPresentation(const cad_core::ShapePtr& shape, const Handle(AIS_Shape)& aisShape);
+    bool IsShapeDisplayed(const cad_core::ShapePtr& shape) const;
+    void IndexDisplayedShape(const cad_core::ShapePtr& shape);
+    void UnindexDisplayedShape(const cad_core::ShapePtr& shape);
+    
+    // 后台剖分辅助
+    bool StartBackgroundMesh(const cad_core::ShapePtr& shape);
+    bool CancelBackgroundMesh(const cad_core::ShapePtr& shape);
+    void CancelAllBackgroundMeshes();
+    static void TransferTriangulations(const TopoDS_Shape& source, const TopoDS_Shape& target);
+    
+    // 显示对象缓存辅助
+    Handle(AIS_Shape) TakeCachedPresentation(const TopoDS_Shape& shape);
+    void CachePresentation(const Handle(AIS_Shape)& aisShape);
+    void EvictPresentations(bool expiredOnly);
+    static size_t EstimatePresentationSize(const TopoDS_Shape& shape);
+    
 private slots:
     void OnRedrawTimer();
+    void OnPresentationCacheTimer();
+    void OnMeshReady(quint64 jobId, bool succeeded);
 };
 
 } // namespace cad_ui
\ No newline at end of file
@@ -74,6 +74,20 @@ void DocumentTree::RemoveShape(const cad_core::ShapePtr& shape) {
     }
 }
 
+void DocumentTree::RemoveShape(const TopoDS_Shape& shape) {
+    if (shape.IsNull()) return;
+    
+    for (int i = 0; i < m_shapesRoot->childCount(); ++i) {
+        QTreeWidgetItem* item = m_shapesRoot->child(i);
+        auto itemShape = item->data(0, Qt::UserRole).value<cad_core::ShapePtr>();
+        if (itemShape && itemShape->GetOCCTShape().IsSame(shape)) {
+            m_shapesRoot->removeChild(item);
+            delete item;
+            break;
+        }
+    }
+}
+
 void DocumentTree::AddFeature(const cad_feature::FeaturePtr& feature) {
     if (!feature) return;
     
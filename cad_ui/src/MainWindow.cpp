@@ -30,7 +30,9 @@
 #include <QVBoxLayout>
 #include <QFrame>
 #include <QLabel>
+#include <QElapsedTimer>
 #include <map>
+#include <algorithm>
 #pragma execution_character_set("utf-8")
 
 namespace cad_ui {
@@ -305,6 +307,12 @@ void MainWindow::CreateActions() {
     m_themeGroup->addAction(m_darkThemeAction);
     m_themeGroup->addAction(m_lightThemeAction);
     
+    m_compactDocumentAction = new QAction("&Compact Document", this);
+    m_compactDocumentAction->setStatusTip("Purge deleted shapes that can no longer be undone");
+    
+    m_selectEdgesByRadiusAction = new QAction("Select Edges by &Radius...", this);
+    m_selectEdgesByRadiusAction->setStatusTip("Select all circular edges of a given radius for fillet/chamfer");
+    
     // Help actions
     m_aboutAction = new QAction("&About", this);
     m_aboutAction->setStatusTip("Show the application's About box");
@@ -378,6 +386,10 @@ void MainWindow::CreateMenus() {
     QMenu* toolsMenu = menuBar()->addMenu("&Tools");
     toolsMenu->addAction(m_darkThemeAction);
     toolsMenu->addAction(m_lightThemeAction);
+    toolsMenu->addSeparator();
+    toolsMenu->addAction(m_selectEdgesByRadiusAction);
+    toolsMenu->addSeparator();
+    toolsMenu->addAction(m_compactDocumentAction);
     
     // Help menu
     QMenu* helpMenu = menuBar()->addMenu("&Help");
@@ -829,6 +841,8 @@ void MainWindow::ConnectSignals() {
     // Theme actions
     connect(m_darkThemeAction, &QAction::triggered, this, &MainWindow::OnDarkTheme);
     connect(m_lightThemeAction, &QAction::triggered, this, &MainWindow::OnLightTheme);
+    connect(m_compactDocumentAction, &QAction::triggered, this, &MainWindow::OnCompactDocument);
+    connect(m_selectEdgesByRadiusAction, &QAction::triggered, this, &MainWindow::OnSelectEdgesByRadius);
     
     // Help actions
     connect(m_aboutAction, &QAction::triggered, this, &MainWindow::OnAbout);
@@ -880,10 +894,10 @@ void MainWindow::RefreshUIFromOCAF() {
     auto allShapes = m_ocafManager->GetAllShapes();
     qDebug() << "Found" << allShapes.size() << "shapes in OCAF document";
     
+    // Display everything in one batch (single fit and redraw)
+    m_viewer->DisplayShapes(allShapes);
     for (const auto& shape : allShapes) {
         if (shape) {
-            // Display in 3D viewer
-            m_viewer->DisplayShape(shape);
             // Add to document tree
             m_documentTree->AddShape(shape);
         }
@@ -899,6 +913,55 @@ void MainWindow::RefreshUIFromOCAF() {
     qDebug() << "UI refresh completed";
 }
 
+void MainWindow::SyncUIWithOCAFChanges() {
+    if (!m_ocafManager || !m_ocafManager->GetDocument()) {
+        return;
+    }
+    
+    const auto& changes = m_ocafManager->GetDocument()->GetLastChanges();
+    qDebug() << "Syncing UI with" << changes.size() << "changed shapes";
+    
+    std::vector<cad_core::ShapePtr> removedShapes;
+    std::vector<cad_core::ShapePtr> addedShapes;
+    for (const auto& change : changes) {
+        // Drop the presentation and tree item of the shape the label held before.
+        // Other labels may hold the same shape, so take a display not claimed by an earlier change
+        if (!change.oldShape.IsNull()) {
+            cad_core::ShapePtr oldShape;
+            for (const auto& displayed : m_viewer->FindDisplayedShapes(change.oldShape)) {
+                if (std::find(removedShapes.begin(), removedShapes.end(), displayed) == removedShapes.end()) {
+                    oldShape = displayed;
+                    break;
+                }
+            }
+            if (oldShape) {
+                removedShapes.push_back(oldShape);
+                m_documentTree->RemoveShape(oldShape);
+            } else {
+                // Not shown in the viewer (hidden or never displayed), the tree item still goes
+                m_documentTree->RemoveShape(change.oldShape);
+            }
+        }
+        
+        // Show the shape the label holds now
+        if (!change.newShape.IsNull()) {
+            auto newShape = std::make_shared<cad_core::Shape>(change.newShape);
+            addedShapes.push_back(newShape);
+            m_documentTree->AddShape(newShape);
+        }
+    }
+    
+    // Remove first so that presentations go back to the cache before they are reused
+    m_viewer->RemoveShapes(removedShapes);
+    m_viewer->DisplayShapes(addedShapes);
+    
+    // Selections may refer to shapes that were just removed
+    m_viewer->ClearSelection();
+    m_viewer->ClearEdgeSelection();
+    
+    m_viewer->RedrawAll();
+}
+
 void MainWindow::UpdateWindowTitle() {
     QString title = "Ander CAD";
     if (!m_currentFileName.isEmpty()) {
@@ -994,8 +1057,8 @@ void MainWindow::OnUndo() {
     qDebug() << "OnUndo called - checking undo availability:" << m_ocafManager->CanUndo();
     if (m_ocafManager->Undo()) {
         qDebug() << "Undo operation successful, refreshing UI";
-        // Refresh UI from OCAF document state
-        RefreshUIFromOCAF();
+        // Update only the shapes touched by this undo
+        SyncUIWithOCAFChanges();
         SetDocumentModified(true);
         UpdateActions();
         statusBar()->showMessage("Undo completed", 2000);
@@ -1010,8 +1073,8 @@ void MainWindow::OnRedo() {
     qDebug() << "OnRedo called - checking redo availability:" << m_ocafManager->CanRedo();
     if (m_ocafManager->Redo()) {
         qDebug() << "Redo operation successful, refreshing UI";
-        // Refresh UI from OCAF document state
-        RefreshUIFromOCAF();
+        // Update only the shapes touched by this redo
+        SyncUIWithOCAFChanges();
         SetDocumentModified(true);
         UpdateActions();
         statusBar()->showMessage("Redo completed", 2000);
@@ -1231,6 +1294,46 @@ void MainWindow::OnLightTheme() {
     m_themeManager->SetTheme("light");
 }
 
+void MainWindow::OnCompactDocument() {
+    cad_core::CompactionStatistics stats = m_ocafManager->CompactDocument();
+    statusBar()->showMessage(QString("Reclaimed %1 labels (~%2 KB), %3 deleted shapes still undoable")
+                                 .arg(stats.reclaimedLabels)
+                                 .arg(stats.reclaimedBytes / 1024)
+                                 .arg(stats.pendingLabels), 5000);
+}
+
+void MainWindow::OnSelectEdgesByRadius() {
+    bool ok = false;
+    double radius = QInputDialog::getDouble(this, "Select Edges by Radius", "Radius:", 1.0, 0.0, 1.0e6, 4, &ok);
+    if (!ok) {
+        return;
+    }
+    
+    // Fillet/chamfer reads the viewer's edge selection, so the query feeds it directly
+    if (m_selectionModeCombo && m_selectionModeCombo->currentIndex() != 2) {
+        m_selectionModeCombo->setCurrentIndex(2); // Edge mode
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    const double tolerance = std::max(Precision::Confusion(), radius * 1.0e-6);
+    int selected = 0;
+    for (const auto& shape : m_ocafManager->GetAllShapes()) {
+        cad_core::ShapePtr displayed = shape ? m_viewer->FindDisplayedShape(shape->GetOCCTShape()) : nullptr;
+        if (!displayed) {
+            continue;
+        }
+        
+        const cad_core::TopologyQuery& query = displayed->GetTopologyQuery();
+        selected += m_viewer->AddEdgesToSelection(displayed, query.GetEdges(query.FindCircularEdges(radius, tolerance)));
+    }
+    
+    statusBar()->showMessage(QString("Selected %1 circular edges of radius %2 (%3 ms)")
+                                 .arg(selected)
+                                 .arg(radius)
+                                 .arg(timer.elapsed()), 5000);
+}
+
 void MainWindow::OnAbout() {
     AboutDialog dialog(this);
     dialog.exec();
@@ -1493,6 +1596,9 @@ void MainWindow::CloseDocumentTab(int index) {
         // For now, just close without checking
         m_tabWidget->removeTab(index);
         viewer->deleteLater();
+        
+        // Cached boolean results reference shapes of the closed document
+        cad_core::BooleanOperations::GetResultCache().Clear();
     }
 }
 
@@ -1792,68 +1898,45 @@ void MainWindow::OnBooleanOperationRequested(BooleanOperationType type,
     cad_core::ShapePtr result;
     try {
         if (type == BooleanOperationType::Union) {
-            // Combine all targets and tools for union
+            // Combine all targets and tools, fused in a single n-ary pass
             std::vector<cad_core::ShapePtr> allShapes = targets;
             allShapes.insert(allShapes.end(), tools.begin(), tools.end());
-            result = cad_core::BooleanOperations::Union(allShapes);
+            result = cad_core::BooleanOperations::BooleanOperation(
+                allShapes, cad_core::BooleanOperations::BooleanType::Union);
         } else if (type == BooleanOperationType::Intersection) {
-            // Use first target as base, intersect with all others
-            result = targets[0];
-            for (size_t i = 1; i < targets.size(); ++i) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Intersection({result, targets[i]});
-                }
-            }
-            for (const auto& tool : tools) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Intersection({result, tool});
-                }
-            }
+            // Intersect all targets and tools in a single n-ary pass
+            std::vector<cad_core::ShapePtr> allShapes = targets;
+            allShapes.insert(allShapes.end(), tools.begin(), tools.end());
+            result = cad_core::BooleanOperations::BooleanOperation(
+                allShapes, cad_core::BooleanOperations::BooleanType::Intersection);
         } else if (type == BooleanOperationType::Difference) {
-            // Use first target as base, subtract all tools
-            result = targets[0];
-            for (const auto& tool : tools) {
-                if (result) {
-                    result = cad_core::BooleanOperations::Difference(result, tool);
-                }
-            }
+            // Use first target as base, subtract all tools in one cut
+            result = cad_core::BooleanOperations::Difference(targets[0], tools);
         }
         
         if (result) {
+            const auto& stats = cad_core::BooleanOperations::GetLastSimplifyStatistics();
+            if (stats.facesBefore > 0) {
+                qDebug() << operationName << "result simplified: faces" << stats.facesBefore << "->" << stats.facesAfter
+                         << ", edges" << stats.edgesBefore << "->" << stats.edgesAfter;
+            }
+            
             // Add result to document
             if (m_ocafManager->AddShape(result, (operationName + " Result").toStdString())) {
-                // Display the new result shape
-                m_viewer->DisplayShape(result);
                 m_documentTree->AddShape(result);
                 
-                // For Union: Remove all original objects (targets and tools) from OCAF
-                // For Intersection/Difference: Remove original and tool objects from OCAF, keep only result
-                if (type == BooleanOperationType::Union) {
-                    // Union: Remove all input objects (targets + tools) from OCAF document
-                    for (const auto& shape : targets) {
-                        m_ocafManager->RemoveShape(shape);  // Remove from OCAF
-                        m_viewer->RemoveShape(shape);       // Remove from 3D view
-                        m_documentTree->RemoveShape(shape); // Remove from document tree
-                    }
-                    for (const auto& shape : tools) {
-                        m_ocafManager->RemoveShape(shape);  // Remove from OCAF
-                        m_viewer->RemoveShape(shape);       // Remove from 3D view
-                        m_documentTree->RemoveShape(shape); // Remove from document tree
-                    }
-                } else {
-                    // Intersection/Difference: Remove original and tool objects from OCAF
-                    for (const auto& shape : targets) {
-                        m_ocafManager->RemoveShape(shape);  // Remove from OCAF
-                        m_viewer->RemoveShape(shape);       // Remove from 3D view
-                        m_documentTree->RemoveShape(shape); // Remove from document tree
-                    }
-                    for (const auto& shape : tools) {
-                        m_ocafManager->RemoveShape(shape);  // Remove from OCAF
-                        m_viewer->RemoveShape(shape);       // Remove from 3D view
-                        m_documentTree->RemoveShape(shape); // Remove from document tree
-                    }
+                // Every operation consumes all of its inputs (targets and tools); only the result stays
+                std::vector<cad_core::ShapePtr> consumedShapes = targets;
+                consumedShapes.insert(consumedShapes.end(), tools.begin(), tools.end());
+                for (const auto& shape : consumedShapes) {
+                    m_ocafManager->RemoveShape(shape);  // Remove from OCAF
+                    m_documentTree->RemoveShape(shape); // Remove from document tree
                 }
                 
+                // Remove the inputs in one batch, then show the result so the fit ignores them
+                m_viewer->RemoveShapes(consumedShapes);
+                m_viewer->DisplayShapes({result});
+                
                 m_ocafManager->CommitTransaction();
                 SetDocumentModified(true);
                 UpdateActions();
@@ -1900,57 +1983,81 @@ void MainWindow::OnFilletChamferOperationRequested(FilletChamferType type,
     m_ocafManager->StartTransaction(operationName.toStdString());
     
     try {
-        bool anySuccess = false;
+        // Build all bodies in parallel, one fillet/chamfer builder per body
+        std::vector<cad_core::FilletChamferBodyResult> bodyResults;
+        if (type == FilletChamferType::Fillet) {
+            // Edges that cannot be filleted are isolated instead of failing the whole body
+            bodyResults = cad_core::FilletChamferOperations::CreateFillet(edgesByShape, radius, true);
+        } else {
+            bodyResults = cad_core::FilletChamferOperations::CreateChamfer(edgesByShape, distance1);
+        }
         
-        // Process each shape that has selected edges
-        for (const auto& shapeEdgePair : edgesByShape) {
-            cad_core::ShapePtr baseShape = shapeEdgePair.first;
-            const std::vector<TopoDS_Edge>& edges = shapeEdgePair.second;
+        // Commit the successful bodies on the UI thread inside the single transaction
+        bool anySuccess = false;
+        QStringList failures;
+        QStringList skippedEdges;
+        std::vector<cad_core::ShapePtr> displayedResults;
+        std::vector<cad_core::ShapePtr> removedBases;
+        for (size_t i = 0; i < bodyResults.size(); ++i) {
+            const auto& bodyResult = bodyResults[i];
+            cad_core::ShapePtr baseShape = bodyResult.original;
+            cad_core::ShapePtr result = bodyResult.result;
             
-            if (!baseShape || edges.empty()) {
+            if (!bodyResult.Succeeded()) {
+                qDebug() << operationName << "operation failed for body" << (i + 1) << ":"
+                         << QString::fromStdString(bodyResult.error);
+                failures << QString("Body %1 (%2 edges): %3").arg(i + 1).arg(bodyResult.edgeCount)
+                                .arg(QString::fromStdString(bodyResult.error));
                 continue;
             }
             
-            qDebug() << "Processing" << edges.size() << "edges on shape";
-            
-            // Perform the operation on this shape with its edges
-            cad_core::ShapePtr result;
-            if (type == FilletChamferType::Fillet) {
-                result = cad_core::FilletChamferOperations::CreateFillet(baseShape, edges, radius);
-            } else {
-                result = cad_core::FilletChamferOperations::CreateChamfer(baseShape, edges, distance1);
-            }
-            
-            if (result) {
-                QString shapeName = QString("%1 Result on Shape").arg(operationName);
-                if (m_ocafManager->AddShape(result, shapeName.toStdString())) {
-                    // Remove the original shape from OCAF, viewer, and document tree
-                    qDebug() << "Removing original shape before displaying" << operationName << "result";
-                    m_ocafManager->RemoveShape(baseShape);  // Remove from OCAF
-                    m_viewer->RemoveShape(baseShape);       // Remove from 3D view
-                    m_documentTree->RemoveShape(baseShape); // Remove from document tree
-                    
-                    // Display the new result
-                    m_viewer->DisplayShape(result);
-                    m_documentTree->AddShape(result);
-                    anySuccess = true;
-                    qDebug() << "Successfully created" << operationName << "with" << edges.size() << "edges";
-                } else {
-                    qDebug() << "Failed to add" << operationName << "result to OCAF";
+            QString shapeName = QString("%1 Result on Shape").arg(operationName);
+            if (m_ocafManager->AddShape(result, shapeName.toStdString())) {
+                // Remove the original shape from OCAF, viewer, and document tree
+                qDebug() << "Removing original shape before displaying" << operationName << "result";
+                m_ocafManager->RemoveShape(baseShape);  // Remove from OCAF
+                m_documentTree->RemoveShape(baseShape); // Remove from document tree
+                
+                // Update the 3D view once all bodies are processed
+                removedBases.push_back(baseShape);
+                displayedResults.push_back(result);
+                m_documentTree->AddShape(result);
+                anySuccess = true;
+                qDebug() << "Successfully created" << operationName << "with" << bodyResult.edgeCount << "edges";
+                
+                if (!bodyResult.rejectedEdges.empty()) {
+                    skippedEdges << QString("Body %1: %2 of %3 edges could not be filleted and were skipped")
+                                    .arg(i + 1).arg(bodyResult.rejectedEdges.size()).arg(bodyResult.edgeCount);
                 }
             } else {
-                qDebug() << operationName << "operation failed for this shape";
+                qDebug() << "Failed to add" << operationName << "result to OCAF";
+                failures << QString("Body %1 (%2 edges): failed to add result to document")
+                                .arg(i + 1).arg(bodyResult.edgeCount);
             }
         }
         
         if (anySuccess) {
+            m_viewer->RemoveShapes(removedBases);
+            m_viewer->DisplayShapes(displayedResults);
             m_ocafManager->CommitTransaction();
             SetDocumentModified(true);
             UpdateActions();
-            statusBar()->showMessage(operationName + " completed successfully");
+            if (failures.isEmpty() && skippedEdges.isEmpty()) {
+                statusBar()->showMessage(operationName + " completed successfully");
+            } else if (failures.isEmpty()) {
+                statusBar()->showMessage(operationName + " completed with skipped edges");
+                QMessageBox::warning(this, operationName, skippedEdges.join("\n"));
+            } else {
+                statusBar()->showMessage(QString("%1 completed on %2 of %3 bodies")
+                                             .arg(operationName)
+                                             .arg(bodyResults.size() - failures.size())
+                                             .arg(bodyResults.size()));
+                QMessageBox::warning(this, operationName,
+                                     QString("%1 failed on some bodies:\n%2").arg(operationName).arg((failures + skippedEdges).join("\n")));
+            }
         } else {
             m_ocafManager->AbortTransaction();
-            QMessageBox::warning(this, "Error", operationName + " operation failed.");
+            QMessageBox::warning(this, "Error", operationName + " operation failed.\n" + failures.join("\n"));
         }
     } catch (const std::exception& e) {
         m_ocafManager->AbortTransaction();
@@ -2015,11 +2122,13 @@ void MainWindow::OnTransformOperationRequested(std::shared_ptr<cad_core::Transfo
             m_ocafManager->StartTransaction("Transform Objects");
             
             // Replace shapes in OCAF document
+            std::vector<cad_core::ShapePtr> replacedShapes;
+            std::vector<cad_core::ShapePtr> newShapes;
             for (size_t i = 0; i < originalShapes.size() && i < transformedShapes.size(); ++i) {
                 if (m_ocafManager->ReplaceShape(originalShapes[i], transformedShapes[i])) {
-                    // Update display
-                    m_viewer->RemoveShape(originalShapes[i]);
-                    m_viewer->DisplayShape(transformedShapes[i]);
+                    // Update display in one batch after the loop
+                    replacedShapes.push_back(originalShapes[i]);
+                    newShapes.push_back(transformedShapes[i]);
                     
                     // Update document tree
                     m_documentTree->RemoveShape(originalShapes[i]);
@@ -2034,8 +2143,8 @@ void MainWindow::OnTransformOperationRequested(std::shared_ptr<cad_core::Transfo
             // Commit transaction
             m_ocafManager->CommitTransaction();
             
-            // Update display and mark as modified
-            RefreshUIFromOCAF();
+            m_viewer->RemoveShapes(replacedShapes);
+            m_viewer->DisplayShapes(newShapes);
             SetDocumentModified(true);
             
             // Update status bar
@@ -2066,7 +2175,15 @@ void MainWindow::OnTransformPreviewRequested(std::shared_ptr<cad_core::Transform
             OnTransformResetRequested();
         }
         
-        // Get preview shapes from command
+        // Rigid moves and uniform scales are previewed by moving the existing presentations,
+        // so nothing is built or meshed until the transform is applied
+        if (command->HasExactTransformation()) {
+            m_viewer->SetPreviewTransformation(command->GetOriginalShapes(), command->GetTransformation());
+            m_previewActive = true;
+            return;
+        }
+        
+        // Non-uniform scale cannot be expressed as a presentation transformation
         auto previewShapes = command->GetTransformedShapes();
         
         if (!previewShapes.empty()) {
@@ -2075,15 +2192,8 @@ void MainWindow::OnTransformPreviewRequested(std::shared_ptr<cad_core::Transform
             m_previewActive = true;
             
             // Display preview shapes with a different color/style
-            for (const auto& shape : m_previewShapes) {
-                if (shape && shape->IsValid()) {
-                    // TODO: Set preview material/color (semi-transparent or different color)
-                    m_viewer->DisplayShape(shape);
-                }
-            }
-            
-            // Update display
-            m_viewer->update();
+            // TODO: Set preview material/color (semi-transparent or different color)
+            m_viewer->DisplayShapes(m_previewShapes);
         }
     } catch (const std::exception& e) {
         QMessageBox::warning(this, "错误", QString("预览生成失败: %1").arg(e.what()));
@@ -2095,12 +2205,11 @@ void MainWindow::OnTransformResetRequested() {
         return;
     }
     
+    // Restore presentations moved by the preview
+    m_viewer->ClearPreviewTransformation();
+    
     // Remove preview shapes from display
-    for (const auto& shape : m_previewShapes) {
-        if (shape) {
-            m_viewer->RemoveShape(shape);
-        }
-    }
+    m_viewer->RemoveShapes(m_previewShapes);
     
     // Clear preview data
     m_previewShapes.clear();
@@ -18,6 +18,11 @@ PropertyPanel::PropertyPanel(QWidget* parent) : QWidget(parent) {
     
     setLayout(m_mainLayout);
     
+    // Polls background mass-property computation of large shapes
+    m_propertiesTimer = new QTimer(this);
+    m_propertiesTimer->setInterval(50);
+    connect(m_propertiesTimer, &QTimer::timeout, this, &PropertyPanel::OnPropertiesTimer);
+    
     // Initialize with empty state
     Clear();
 }
@@ -60,8 +65,23 @@ void PropertyPanel::CreateShapeProperties() {
     AddProperty("Valid", m_currentShape->IsValid() ? "Yes" : "No");
     
     if (m_currentShape->IsValid()) {
-        AddProperty("Volume", m_currentShape->Volume());
-        AddProperty("Area", m_currentShape->Area());
+        // Mass properties are computed in the background so that selecting
+        // a large import does not block the UI
+        if (m_currentShape->ArePropertiesReady()) {
+            const cad_core::ShapeProperties& props = m_currentShape->GetProperties();
+            AddProperty("Volume", props.volume);
+            AddProperty("Area", props.area);
+            AddProperty("Centroid", QString("(%1, %2, %3)")
+                .arg(props.centroid.X(), 0, 'f', 3)
+                .arg(props.centroid.Y(), 0, 'f', 3)
+                .arg(props.centroid.Z(), 0, 'f', 3));
+        } else {
+            m_currentShape->ComputePropertiesAsync();
+            AddProperty("Volume", "Computing...");
+            AddProperty("Area", "Computing...");
+            AddProperty("Centroid", "Computing...");
+            m_propertiesTimer->start();
+        }
     }
     
     // Add stretch at the end
@@ -120,7 +140,21 @@ void PropertyPanel::CreateFeatureProperties() {
     m_contentLayout->addStretch();
 }
 
+void PropertyPanel::OnPropertiesTimer() {
+    if (!m_currentShape) {
+        m_propertiesTimer->stop();
+        return;
+    }
+    
+    if (m_currentShape->ArePropertiesReady()) {
+        m_propertiesTimer->stop();
+        ClearProperties();
+        CreateShapeProperties();
+    }
+}
+
 void PropertyPanel::ClearProperties() {
+    m_propertiesTimer->stop();
     QLayoutItem* item;
     while ((item = m_contentLayout->takeAt(0)) != nullptr) {
         delete item->widget();
@@ -19,7 +19,28 @@
 #include <TopoDS.hxx>
 #include <TopAbs.hxx>
 #include <Prs3d_LineAspect.hxx>
+#include <Graphic3d_TransformPers.hxx>
 #include <Quantity_Color.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Compound.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <BRepTools.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressScope.hxx>
+#include <Standard_Failure.hxx>
+#include <QRunnable>
+#include <functional>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <WNT_Window.hxx>
@@ -32,9 +53,40 @@
 
 namespace cad_ui {
 
+namespace {
+
+// Runs one meshing job on the view's thread pool
+class MeshRunnable : public QRunnable {
+public:
+    explicit MeshRunnable(std::function<void()> work) : m_work(std::move(work)) {}
+    void run() override { m_work(); }
+
+private:
+    std::function<void()> m_work;
+};
+
+// Lets BRepMesh stop early once the shape was removed from the view
+class MeshCancelIndicator : public Message_ProgressIndicator {
+public:
+    explicit MeshCancelIndicator(std::shared_ptr<std::atomic<bool>> cancelled)
+        : m_cancelled(std::move(cancelled)) {}
+    Standard_Boolean UserBreak() override { return m_cancelled->load(); }
+
+protected:
+    void Show(const Message_ProgressScope&, const Standard_Boolean) override {}
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+} // namespace
+
 QtOccView::QtOccView(QWidget* parent) 
     : QWidget(parent), m_isInitialized(false), m_currentMouseButton(Qt::NoButton),
-      m_currentSelectedShape(nullptr), m_currentSelectionMode(0) {
+      m_fullRedrawPending(false), m_immediateRedrawPending(false),
+      m_presentationCacheUsage(0), m_presentationCacheBudget(128 * 1024 * 1024),
+      m_presentationCacheMaxAge(60000), m_nextMeshJobId(1), m_backgroundMeshThreshold(200),
+      m_currentSelectedShape(nullptr), m_currentSelectionMode(0), m_areaSelection(AreaSelection::None) {
     
     // Set widget attributes to reduce flicker
     setAttribute(Qt::WA_PaintOnScreen);
@@ -46,11 +98,34 @@ QtOccView::QtOccView(QWidget* parent)
     setFocusPolicy(Qt::StrongFocus);
     setAutoFillBackground(false);  // Don't fill background to reduce flicker
     
-    // Initialize timer for redraw
+    // Frame scheduler: every redraw request goes through this timer and is coalesced
     m_redrawTimer = new QTimer(this);
     m_redrawTimer->setSingleShot(true);
     connect(m_redrawTimer, &QTimer::timeout, this, &QtOccView::OnRedrawTimer);
     
+    // Periodically drop cached presentations that have not been reused in time
+    m_presentationClock.start();
+    m_presentationCacheTimer = new QTimer(this);
+    m_presentationCacheTimer->setInterval(5000);
+    connect(m_presentationCacheTimer, &QTimer::timeout, this, &QtOccView::OnPresentationCacheTimer);
+    
+    // Merged highlight overlays: one object per set, drawn in the immediate Top layer
+    auto createHighlight = [](HighlightOverlay& overlay, int displayMode) {
+        overlay.aisShape = new AIS_Shape(TopoDS_Compound());
+        overlay.aisShape->SetDisplayMode(displayMode);
+        overlay.aisShape->SetZLayer(Graphic3d_ZLayerId_Top);
+    };
+    createHighlight(m_edgeHighlight, AIS_WireFrame);
+    Handle(Prs3d_Drawer) edgeDrawer = m_edgeHighlight.aisShape->Attributes();
+    edgeDrawer->SetLineAspect(new Prs3d_LineAspect(Quantity_NOC_RED, Aspect_TOL_SOLID, 3.0));
+    edgeDrawer->SetWireAspect(new Prs3d_LineAspect(Quantity_NOC_RED, Aspect_TOL_SOLID, 3.0));
+    createHighlight(m_vertexHighlight, AIS_WireFrame);
+    m_vertexHighlight.aisShape->SetColor(Quantity_NOC_RED);
+    m_vertexHighlight.aisShape->SetWidth(5.0);
+    createHighlight(m_faceHighlight, AIS_Shaded);
+    m_faceHighlight.aisShape->SetColor(Quantity_NOC_RED);
+    m_faceHighlight.aisShape->SetTransparency(0.3);
+    
     // Initialize selection manager
     m_selectionManager = std::make_unique<cad_core::SelectionManager>();
     
@@ -61,6 +136,12 @@ QtOccView::QtOccView(QWidget* parent)
     InitializeOCC();
 }
 
+QtOccView::~QtOccView() {
+    // Workers post back to this view, so they must be finished before it goes away
+    CancelAllBackgroundMeshes();
+    m_meshPool.waitForDone();
+}
+
 bool QtOccView::InitViewer() {
     if (m_isInitialized) {
         return true;
@@ -149,7 +230,7 @@ bool QtOccView::InitViewer() {
         // Initial view setup and render
         FitAll();
         ShowAxes(false);  // 默认显示坐标轴
-        m_view->Redraw();  // 确保初始渲染
+        RequestRedraw();  // 确保初始渲染
         
         return true;
     } catch (const Standard_Failure& e) {
@@ -163,21 +244,21 @@ void QtOccView::FitAll() {
     
     m_view->FitAll();
     m_view->ZFitAll();
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ZoomIn() {
     if (m_view.IsNull()) return;
     
     m_view->SetZoom(1.5);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ZoomOut() {
     if (m_view.IsNull()) return;
     
     m_view->SetZoom(0.75);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::Pan(int dx, int dy) {
@@ -198,11 +279,11 @@ void QtOccView::SetViewMode(const QString& mode) {
     if (m_view.IsNull()) return;
     
     if (mode == "wireframe") {
-        m_context->SetDisplayMode(AIS_WireFrame, Standard_True);
+        m_context->SetDisplayMode(AIS_WireFrame, Standard_False);
     } else if (mode == "shaded") {
-        m_context->SetDisplayMode(AIS_Shaded, Standard_True);
+        m_context->SetDisplayMode(AIS_Shaded, Standard_False);
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::SetProjectionMode(bool orthographic) {
@@ -213,38 +294,313 @@ void QtOccView::SetProjectionMode(bool orthographic) {
     } else {
         m_view->Camera()->SetProjectionType(Graphic3d_Camera::Projection_Perspective);
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::DisplayShape(const cad_core::ShapePtr& shape) {
-    if (!shape || shape->GetOCCTShape().IsNull() || m_context.IsNull()) {
+    Handle(AIS_Shape) aisShape = DisplayShapeNoUpdate(shape);
+    if (!aisShape.IsNull()) {
+        ActivateSelectionModes(aisShape);
+    } else if (!IsShapeDisplayed(shape)) {
         return;
     }
     
-    Handle(AIS_Shape) aisShape = new AIS_Shape(shape->GetOCCTShape());
+    // Fit all objects in view to ensure visibility and render
+    m_view->FitAll();
+    RequestRedraw();
     
-    // Set shape properties for better visibility
-    aisShape->SetColor(Quantity_NOC_ORANGE);
-    aisShape->SetTransparency(0.0);
+    // Force immediate rendering
+    update();
+}
+
+void QtOccView::DisplayShapes(const std::vector<cad_core::ShapePtr>& shapes) {
+    if (m_context.IsNull()) {
+        return;
+    }
     
-    m_context->Display(aisShape, Standard_False);
+    // Put every presentation into the context first, without any redraw
+    std::vector<Handle(AIS_Shape)> displayed;
+    displayed.reserve(shapes.size());
+    bool anyPending = false;
+    for (const auto& shape : shapes) {
+        Handle(AIS_Shape) aisShape = DisplayShapeNoUpdate(shape);
+        if (!aisShape.IsNull()) {
+            displayed.push_back(aisShape);
+        } else if (IsShapeDisplayed(shape)) {
+            anyPending = true;  // bounding-box placeholder shown, mesh still running
+        }
+    }
     
-    // Store mapping for selection synchronization
-    m_shapeToAIS[shape] = aisShape;
+    if (displayed.empty() && !anyPending) {
+        return;
+    }
     
-    // Enable selection modes for this shape
-    m_context->SetSelectionModeActive(aisShape, 0, Standard_True); // Shape
-    m_context->SetSelectionModeActive(aisShape, 1, Standard_True); // Vertex
-    m_context->SetSelectionModeActive(aisShape, 2, Standard_True); // Edge
-    m_context->SetSelectionModeActive(aisShape, 4, Standard_True); // Face
+    // Selection is activated once all shapes are in, then one fit and one redraw
+    for (const auto& aisShape : displayed) {
+        ActivateSelectionModes(aisShape);
+    }
     
-    // Fit all objects in view to ensure visibility and render
     m_view->FitAll();
-    m_view->Redraw();
+    RequestRedraw();
+    update();
+}
+
+void QtOccView::RemoveShapes(const std::vector<cad_core::ShapePtr>& shapes) {
+    if (m_context.IsNull()) {
+        return;
+    }
     
-    // Force immediate rendering
+    for (const auto& shape : shapes) {
+        RemoveShapeNoUpdate(shape);
+    }
+    
+    RequestRedraw();
     update();
 }
+
+Handle(AIS_Shape) QtOccView::DisplayShapeNoUpdate(const cad_core::ShapePtr& shape) {
+    if (!shape || shape->GetOCCTShape().IsNull() || m_context.IsNull()) {
+        return Handle(AIS_Shape)();
+    }
+    
+    // Reuse an erased presentation of the same TShape+location (undo/redo) with its mesh and BVH
+    Handle(AIS_Shape) aisShape = TakeCachedPresentation(shape->GetOCCTShape());
+    if (aisShape.IsNull()) {
+        // Large unmeshed shapes get a placeholder now and their real presentation later
+        if (StartBackgroundMesh(shape)) {
+            return Handle(AIS_Shape)();
+        }
+        
+        aisShape = new AIS_Shape(shape->GetOCCTShape());
+        
+        // Set shape properties for better visibility
+        aisShape->SetColor(Quantity_NOC_ORANGE);
+        aisShape->SetTransparency(0.0);
+    }
+    
+    RegisterPresentation(shape, aisShape);
+    return aisShape;
+}
+
+void QtOccView::RegisterPresentation(const cad_core::ShapePtr& shape, const Handle(AIS_Shape)& aisShape) {
+    // Display without the default selection mode; ActivateSelectionModes builds only the current one
+    const Standard_Integer displayMode = aisShape->HasDisplayMode()
+        ? aisShape->DisplayMode() : m_context->DefaultDrawer()->DisplayMode();
+    m_context->Display(aisShape, displayMode, -1, Standard_False);
+    
+    // Store mapping for selection synchronization
+    m_shapeToAIS[shape] = aisShape;
+    m_aisToShape[aisShape.get()] = shape;
+    IndexDisplayedShape(shape);
+    m_selectionManager->RegisterShape(aisShape, shape);
+}
+
+bool QtOccView::StartBackgroundMesh(const cad_core::ShapePtr& shape) {
+    if (m_backgroundMeshThreshold <= 0 ||
+        shape->GetTopologyIndex().GetFaces().Extent() < m_backgroundMeshThreshold) {
+        return false;
+    }
+    
+    const Bnd_Box& box = shape->GetBoundingBox();
+    if (box.IsVoid()) {
+        return false;
+    }
+    
+    // Same absolute deflection AIS_Shape derives from the default drawer, so it won't remesh
+    const Handle(Prs3d_Drawer)& drawer = m_context->DefaultDrawer();
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    const Standard_Real maxSize = std::max({xMax - xMin, yMax - yMin, zMax - zMin});
+    IMeshTools_Parameters params;
+    params.Deflection = drawer->TypeOfDeflection() == Aspect_TOD_RELATIVE
+        ? maxSize * drawer->DeviationCoefficient() * 4.0
+        : drawer->MaximalChordialDeviation();
+    params.Angle = drawer->DeviationAngle();
+    params.InParallel = Standard_True;
+    if (params.Deflection <= 0.0) {
+        return false;
+    }
+    
+    // Already meshed (e.g. a moved copy of a displayed shape): nothing to wait for
+    const TopoDS_Shape occtShape = shape->GetOCCTShape();
+    if (BRepTools::Triangulation(occtShape, params.Deflection)) {
+        return false;
+    }
+    
+    // Wireframe box placeholder; the gap keeps flat shapes from producing a degenerate box
+    const Standard_Real gap = std::max(maxSize * 1.0e-3, 1.0e-6);
+    Handle(AIS_Shape) placeholder;
+    try {
+        placeholder = new AIS_Shape(BRepPrimAPI_MakeBox(gp_Pnt(xMin - gap, yMin - gap, zMin - gap),
+                                                        gp_Pnt(xMax + gap, yMax + gap, zMax + gap)).Shape());
+    } catch (const Standard_Failure&) {
+        return false;
+    }
+    // The TFaces may be shared with other Shapes (moves, fast paths, cache hits) that the UI
+    // thread displays or meshes meanwhile, so the worker only ever touches a private copy
+    TopoDS_Shape meshCopy;
+    try {
+        BRepBuilderAPI_Copy copier(occtShape, Standard_False, Standard_False);
+        meshCopy = copier.Shape();
+    } catch (const Standard_Failure&) {
+        return false;
+    }
+    
+    placeholder->SetColor(Quantity_NOC_GRAY60);
+    m_context->Display(placeholder, AIS_WireFrame, -1, Standard_False);
+    
+    const quint64 jobId = m_nextMeshJobId++;
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_meshJobs[jobId] = MeshJob{shape, placeholder, cancelled, meshCopy, params.Deflection};
+    IndexDisplayedShape(shape);
+    
+    m_meshPool.start(new MeshRunnable([this, jobId, meshCopy, params, cancelled]() {
+        bool succeeded = false;
+        if (!cancelled->load()) {
+            try {
+                Handle(MeshCancelIndicator) progress = new MeshCancelIndicator(cancelled);
+                BRepMesh_IncrementalMesh mesher(meshCopy, params, progress->Start());
+                succeeded = mesher.IsDone() && !cancelled->load();
+            } catch (const Standard_Failure&) {
+                succeeded = false;
+            }
+        }
+        
+        // Hand the result back to the UI thread; cancelled jobs are dropped there
+        QMetaObject::invokeMethod(this, "OnMeshReady", Qt::QueuedConnection,
+                                  Q_ARG(quint64, jobId), Q_ARG(bool, succeeded));
+    }));
+    
+    return true;
+}
+
+bool QtOccView::CancelBackgroundMesh(const cad_core::ShapePtr& shape) {
+    for (auto it = m_meshJobs.begin(); it != m_meshJobs.end(); ++it) {
+        if (it->second.shape != shape) {
+            continue;
+        }
+        
+        it->second.cancelled->store(true);
+        if (!m_context.IsNull()) {
+            m_context->Remove(it->second.placeholder, Standard_False);
+        }
+        m_meshJobs.erase(it);
+        
+        UnindexDisplayedShape(shape);
+        return true;
+    }
+    return false;
+}
+
+void QtOccView::CancelAllBackgroundMeshes() {
+    for (auto& entry : m_meshJobs) {
+        entry.second.cancelled->store(true);
+        if (!m_context.IsNull()) {
+            m_context->Remove(entry.second.placeholder, Standard_False);
+        }
+    }
+    m_meshJobs.clear();
+}
+
+void QtOccView::OnMeshReady(quint64 jobId, bool succeeded) {
+    auto it = m_meshJobs.find(jobId);
+    if (it == m_meshJobs.end() || m_context.IsNull()) {
+        return;  // shape was removed while meshing
+    }
+    
+    MeshJob job = it->second;
+    m_meshJobs.erase(it);
+    m_context->Remove(job.placeholder, Standard_False);
+    
+    // Only the UI thread writes onto the original TFaces
+    if (succeeded) {
+        TransferTriangulations(job.meshCopy, job.shape->GetOCCTShape());
+        succeeded = BRepTools::Triangulation(job.shape->GetOCCTShape(), job.deflection);
+    }
+    if (!succeeded) {
+        qDebug() << "Background meshing failed, AIS_Shape will mesh the shape itself";
+    }
+    
+    Handle(AIS_Shape) aisShape = new AIS_Shape(job.shape->GetOCCTShape());
+    aisShape->SetColor(Quantity_NOC_ORANGE);
+    aisShape->SetTransparency(0.0);
+    RegisterPresentation(job.shape, aisShape);
+    ActivateSelectionModes(aisShape);
+    
+    RequestRedraw();
+}
+
+void QtOccView::TransferTriangulations(const TopoDS_Shape& source, const TopoDS_Shape& target) {
+    // The copy has the same structure, so both face maps list the faces in the same order
+    TopTools_IndexedMapOfShape sourceFaces, targetFaces;
+    TopExp::MapShapes(source, TopAbs_FACE, sourceFaces);
+    TopExp::MapShapes(target, TopAbs_FACE, targetFaces);
+    if (sourceFaces.Extent() != targetFaces.Extent()) {
+        return;
+    }
+    
+    // Edges are matched the same way; their polygons on the triangulation must come along,
+    // otherwise OCCT treats the faces as unmeshed and meshes them again
+    TopTools_IndexedMapOfShape sourceEdges, targetEdges;
+    TopExp::MapShapes(source, TopAbs_EDGE, sourceEdges);
+    TopExp::MapShapes(target, TopAbs_EDGE, targetEdges);
+    if (sourceEdges.Extent() != targetEdges.Extent()) {
+        return;
+    }
+    
+    // Triangulations live on the TFace in its own frame, independent of the location
+    BRep_Builder builder;
+    for (int i = 1; i <= targetFaces.Extent(); ++i) {
+        TopLoc_Location location;
+        const TopoDS_Face& sourceFace = TopoDS::Face(sourceFaces(i));
+        const TopoDS_Face& targetFace = TopoDS::Face(targetFaces(i));
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(sourceFace, location);
+        TopLoc_Location targetLocation;
+        if (triangulation.IsNull() || !BRep_Tool::Triangulation(targetFace, targetLocation).IsNull()) {
+            continue;
+        }
+        builder.UpdateFace(targetFace, triangulation);
+        
+        // Polygons are keyed by triangulation and face location, which the copy shares
+        TopTools_IndexedMapOfShape faceEdges;
+        TopExp::MapShapes(targetFace, TopAbs_EDGE, faceEdges);
+        for (int e = 1; e <= faceEdges.Extent(); ++e) {
+            const int edgeIndex = targetEdges.FindIndex(faceEdges(e));
+            if (edgeIndex == 0) {
+                continue;
+            }
+            const TopoDS_Edge sourceEdge = TopoDS::Edge(sourceEdges(edgeIndex).Oriented(TopAbs_FORWARD));
+            const TopoDS_Edge targetEdge = TopoDS::Edge(targetEdges(edgeIndex).Oriented(TopAbs_FORWARD));
+            
+            Handle(Poly_PolygonOnTriangulation) polygon =
+                BRep_Tool::PolygonOnTriangulation(sourceEdge, triangulation, location);
+            if (polygon.IsNull()) {
+                continue;
+            }
+            
+            // A seam edge carries one polygon per side of the face
+            if (BRep_Tool::IsClosed(sourceEdge, sourceFace)) {
+                Handle(Poly_PolygonOnTriangulation) reversedPolygon = BRep_Tool::PolygonOnTriangulation(
+                    TopoDS::Edge(sourceEdge.Reversed()), triangulation, location);
+                builder.UpdateEdge(targetEdge, polygon, reversedPolygon, triangulation, location);
+            } else {
+                builder.UpdateEdge(targetEdge, polygon, triangulation, location);
+            }
+        }
+    }
+}
+
+cad_core::ShapePtr QtOccView::FindShapeForAIS(const Handle(AIS_InteractiveObject)& aisObject) const {
+    if (aisObject.IsNull()) return nullptr;
+    
+    auto it = m_aisToShape.find(aisObject.get());
+    return it != m_aisToShape.end() ? it->second : nullptr;
+}
+
+void QtOccView::ActivateSelectionModes(const Handle(AIS_Shape)& aisShape) {
+    // Only the current mode is activated; other modes are computed on first switch
+    m_selectionManager->ActivateSelection(aisShape);
+}
 QPaintEngine* QtOccView::paintEngine() const
 {
     return nullptr;
@@ -254,32 +610,251 @@ void QtOccView::RemoveShape(const cad_core::ShapePtr& shape) {
         return;
     }
     
+    RemoveShapeNoUpdate(shape);
+    
+    RequestRedraw();
+    update();
+}
+
+void QtOccView::RemoveShapeNoUpdate(const cad_core::ShapePtr& shape) {
+    if (!shape) {
+        return;
+    }
+    
+    // Removed before its mesh was ready: stop the worker and drop the placeholder
+    if (CancelBackgroundMesh(shape)) {
+        return;
+    }
+    
     // Find and remove the AIS_Shape
     auto it = m_shapeToAIS.find(shape);
     if (it != m_shapeToAIS.end()) {
         Handle(AIS_Shape) aisShape = it->second;
         if (!aisShape.IsNull()) {
-            m_context->Remove(aisShape, Standard_False);
+            // Keep the presentation hidden in the context so it can be shown again cheaply
+            CachePresentation(aisShape);
+            m_selectionManager->UnregisterShape(aisShape);
+            m_aisToShape.erase(aisShape.get());
+            m_previewObjects.erase(std::remove(m_previewObjects.begin(), m_previewObjects.end(), aisShape),
+                                   m_previewObjects.end());
         }
         m_shapeToAIS.erase(it);
+        
+        UnindexDisplayedShape(shape);
     }
-    
-    m_view->Redraw();
-    update();
 }
 
 void QtOccView::ClearShapes() {
     if (m_context.IsNull()) return;
     
+    CancelAllBackgroundMeshes();
     m_context->RemoveAll(Standard_False);
+    m_presentationCache.clear();
+    m_presentationCacheUsage = 0;
     m_shapeToAIS.clear(); // Clear the mapping
-    m_view->Redraw();
+    m_aisToShape.clear();
+    m_displayedShapes.clear();
+    m_previewObjects.clear();
+    m_selectionManager->ClearRegisteredShapes();
+    RequestRedraw();
 }
 
 void QtOccView::RedrawAll() {
     if (m_view.IsNull()) return;
     
-    m_view->Redraw();
+    RequestRedraw();
+}
+
+cad_core::ShapePtr QtOccView::FindDisplayedShape(const TopoDS_Shape& shape) const {
+    const std::vector<cad_core::ShapePtr>& displayed = FindDisplayedShapes(shape);
+    return displayed.empty() ? nullptr : displayed.front();
+}
+
+const std::vector<cad_core::ShapePtr>& QtOccView::FindDisplayedShapes(const TopoDS_Shape& shape) const {
+    static const std::vector<cad_core::ShapePtr> empty;
+    if (shape.IsNull()) return empty;
+    
+    auto it = m_displayedShapes.find(shape.Oriented(TopAbs_FORWARD));
+    return it != m_displayedShapes.end() ? it->second : empty;
+}
+
+bool QtOccView::IsShapeDisplayed(const cad_core::ShapePtr& shape) const {
+    if (!shape) return false;
+    
+    const std::vector<cad_core::ShapePtr>& displayed = FindDisplayedShapes(shape->GetOCCTShape());
+    return std::find(displayed.begin(), displayed.end(), shape) != displayed.end();
+}
+
+void QtOccView::IndexDisplayedShape(const cad_core::ShapePtr& shape) {
+    // Several labels can hold the same TopoDS_Shape, each with its own ShapePtr
+    std::vector<cad_core::ShapePtr>& displayed = m_displayedShapes[shape->GetOCCTShape().Oriented(TopAbs_FORWARD)];
+    if (std::find(displayed.begin(), displayed.end(), shape) == displayed.end()) {
+        displayed.push_back(shape);
+    }
+}
+
+void QtOccView::UnindexDisplayedShape(const cad_core::ShapePtr& shape) {
+    auto it = m_displayedShapes.find(shape->GetOCCTShape().Oriented(TopAbs_FORWARD));
+    if (it == m_displayedShapes.end()) {
+        return;
+    }
+    
+    std::vector<cad_core::ShapePtr>& displayed = it->second;
+    displayed.erase(std::remove(displayed.begin(), displayed.end(), shape), displayed.end());
+    if (displayed.empty()) {
+        m_displayedShapes.erase(it);
+    }
+}
+
+void QtOccView::SetPresentationCacheBudget(size_t bytes, int maxAgeMs) {
+    m_presentationCacheBudget = bytes;
+    m_presentationCacheMaxAge = maxAgeMs;
+    EvictPresentations(false);
+}
+
+void QtOccView::ClearPresentationCache() {
+    if (!m_context.IsNull()) {
+        for (const auto& entry : m_presentationCache) {
+            m_context->Remove(entry.second.aisShape, Standard_False);
+        }
+    }
+    m_presentationCache.clear();
+    m_presentationCacheUsage = 0;
+    m_presentationCacheTimer->stop();
+}
+
+Handle(AIS_Shape) QtOccView::TakeCachedPresentation(const TopoDS_Shape& shape) {
+    auto it = m_presentationCache.find(shape.Oriented(TopAbs_FORWARD));
+    if (it == m_presentationCache.end()) {
+        return Handle(AIS_Shape)();
+    }
+    
+    Handle(AIS_Shape) aisShape = it->second.aisShape;
+    m_presentationCacheUsage -= it->second.size;
+    m_presentationCache.erase(it);
+    return aisShape;
+}
+
+void QtOccView::CachePresentation(const Handle(AIS_Shape)& aisShape) {
+    const TopoDS_Shape key = aisShape->Shape().Oriented(TopAbs_FORWARD);
+    
+    // A second erased presentation of the same shape is not worth keeping
+    if (m_presentationCache.count(key) > 0) {
+        m_context->Remove(aisShape, Standard_False);
+        return;
+    }
+    
+    CachedPresentation entry;
+    entry.aisShape = aisShape;
+    entry.erasedAt = m_presentationClock.elapsed();
+    entry.size = EstimatePresentationSize(aisShape->Shape());
+    if (entry.size > m_presentationCacheBudget) {
+        m_context->Remove(aisShape, Standard_False);
+        return;
+    }
+    
+    // Erased objects must not stay in the selection
+    if (m_context->IsSelected(aisShape)) {
+        m_context->ClearSelected(Standard_False);
+    }
+    m_context->Erase(aisShape, Standard_False);
+    m_presentationCache[key] = entry;
+    m_presentationCacheUsage += entry.size;
+    EvictPresentations(false);
+    
+    if (!m_presentationCacheTimer->isActive()) {
+        m_presentationCacheTimer->start();
+    }
+}
+
+void QtOccView::EvictPresentations(bool expiredOnly) {
+    if (m_context.IsNull()) return;
+    
+    // Expired entries go first
+    qint64 now = m_presentationClock.elapsed();
+    for (auto it = m_presentationCache.begin(); it != m_presentationCache.end();) {
+        if (now - it->second.erasedAt >= m_presentationCacheMaxAge) {
+            m_context->Remove(it->second.aisShape, Standard_False);
+            m_presentationCacheUsage -= it->second.size;
+            it = m_presentationCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    // Then the oldest until the cache fits its budget
+    while (!expiredOnly && m_presentationCacheUsage > m_presentationCacheBudget && !m_presentationCache.empty()) {
+        auto oldest = m_presentationCache.begin();
+        for (auto it = m_presentationCache.begin(); it != m_presentationCache.end(); ++it) {
+            if (it->second.erasedAt < oldest->second.erasedAt) {
+                oldest = it;
+            }
+        }
+        m_context->Remove(oldest->second.aisShape, Standard_False);
+        m_presentationCacheUsage -= oldest->second.size;
+        m_presentationCache.erase(oldest);
+    }
+    
+    if (m_presentationCache.empty()) {
+        m_presentationCacheTimer->stop();
+    }
+}
+
+size_t QtOccView::EstimatePresentationSize(const TopoDS_Shape& shape) {
+    // Triangulation dominates: nodes, normals and triangles, plus a per-face overhead
+    // for the presentation arrays and the selection BVH
+    size_t bytes = 0;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), location);
+        bytes += 512;
+        if (!triangulation.IsNull()) {
+            bytes += static_cast<size_t>(triangulation->NbNodes()) * 2 * sizeof(gp_Pnt)
+                   + static_cast<size_t>(triangulation->NbTriangles()) * 3 * sizeof(int) * 2;
+        }
+    }
+    return bytes;
+}
+
+void QtOccView::OnPresentationCacheTimer() {
+    EvictPresentations(true);
+}
+
+void QtOccView::SetPreviewTransformation(const std::vector<cad_core::ShapePtr>& shapes, const gp_Trsf& transformation) {
+    if (m_context.IsNull()) return;
+    
+    TopLoc_Location location(transformation);
+    for (const auto& shape : shapes) {
+        auto it = m_shapeToAIS.find(shape);
+        if (it == m_shapeToAIS.end() || it->second.IsNull()) {
+            continue;
+        }
+        
+        // Move the existing presentation; its triangulation and selection are reused as-is
+        const Handle(AIS_Shape)& aisShape = it->second;
+        if (std::find(m_previewObjects.begin(), m_previewObjects.end(), aisShape) == m_previewObjects.end()) {
+            m_context->SetTransparency(aisShape, 0.6, Standard_False);
+            m_previewObjects.push_back(aisShape);
+        }
+        m_context->SetLocation(aisShape, location);
+    }
+    
+    // No FitAll here: the camera stays put while the user drags the sliders
+    RequestRedraw();
+    update();
+}
+
+void QtOccView::ClearPreviewTransformation() {
+    if (m_context.IsNull() || m_previewObjects.empty()) return;
+    
+    for (const auto& aisShape : m_previewObjects) {
+        m_context->ResetLocation(aisShape);
+        m_context->SetTransparency(aisShape, 0.0, Standard_False);
+    }
+    m_previewObjects.clear();
+    
+    RequestRedraw();
+    update();
 }
 
 void QtOccView::SetBackgroundColor(const QColor& color) {
@@ -287,7 +862,7 @@ void QtOccView::SetBackgroundColor(const QColor& color) {
     
     Quantity_Color occColor(color.redF(), color.greenF(), color.blueF(), Quantity_TOC_RGB);
     m_view->SetBackgroundColor(occColor);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::SetBackgroundGradient(const QColor& color1, const QColor& color2) {
@@ -296,8 +871,8 @@ void QtOccView::SetBackgroundGradient(const QColor& color1, const QColor& color2
     Quantity_Color occColor1(color1.redF(), color1.greenF(), color1.blueF(), Quantity_TOC_RGB);
     Quantity_Color occColor2(color2.redF(), color2.greenF(), color2.blueF(), Quantity_TOC_RGB);
     
-    m_view->SetBgGradientColors(occColor1, occColor2, Aspect_GFM_VER, Standard_True);
-    m_view->Redraw();
+    m_view->SetBgGradientColors(occColor1, occColor2, Aspect_GFM_VER, Standard_False);
+    RequestRedraw();
 }
 
 void QtOccView::SetSelectionMode(int mode) {
@@ -321,35 +896,32 @@ void QtOccView::SetSelectionMode(int mode) {
     
     qDebug() << "SetSelectionMode called with mode:" << mode;
     
-    // Clear all existing selection modes
-    m_context->Deactivate();
-    
-    // Activate the specific selection mode
+    // Switch the active mode per displayed shape; previously computed modes are reused
     switch (mode) {
         case 0: // Shape
-            m_context->Activate(0, Standard_True);
+            m_selectionManager->ActivateMode(cad_core::SelectionMode::Shape);
             qDebug() << "Activated shape selection mode";
             break;
         case 1: // Vertex  
-            m_context->Activate(1, Standard_True);
+            m_selectionManager->ActivateMode(cad_core::SelectionMode::Vertex);
             qDebug() << "Activated vertex selection mode";
             break;
         case 2: // Edge
-            m_context->Activate(2, Standard_True);
+            m_selectionManager->ActivateMode(cad_core::SelectionMode::Edge);
             qDebug() << "Activated edge selection mode";
             break;
         case 4: // Face
-            m_context->Activate(4, Standard_True);
+            m_selectionManager->ActivateMode(cad_core::SelectionMode::Face);
             qDebug() << "Activated face selection mode";
             break;
         default:
-            m_context->Activate(0, Standard_True); // Default to shape selection
+            m_selectionManager->ActivateMode(cad_core::SelectionMode::Shape); // Default to shape selection
             m_currentSelectionMode = 0;
             qDebug() << "Activated default shape selection mode";
             break;
     }
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ClearSelection() {
@@ -367,8 +939,8 @@ void QtOccView::ClearSelection() {
     UnhighlightAllVertices();
     UnhighlightAllFaces();
     
-    m_context->ClearSelected(Standard_True);
-    m_view->Redraw();
+    m_context->ClearSelected(Standard_False);
+    RequestRedraw();
 }
 
 void QtOccView::ShowGrid(bool show) {
@@ -379,7 +951,7 @@ void QtOccView::ShowGrid(bool show) {
     } else {
         m_viewer->DeactivateGrid();
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::SetGridSpacing(double spacing) {
@@ -389,7 +961,7 @@ void QtOccView::SetGridSpacing(double spacing) {
     // In a real implementation, you'd set the grid spacing properly
     Q_UNUSED(spacing);
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::ShowAxes(bool show) {
@@ -400,7 +972,7 @@ void QtOccView::ShowAxes(bool show) {
     } else {
         m_view->TriedronErase();
     }
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::paintEvent(QPaintEvent* event) {
@@ -439,6 +1011,15 @@ void QtOccView::mousePressEvent(QMouseEvent* event) {
         return;
     }
 
+    // Shift+drag starts a box selection, Ctrl+Shift+drag a lasso; no rotation or point pick
+    if (event->button() == Qt::LeftButton && (event->modifiers() & Qt::ShiftModifier) && !m_view.IsNull()) {
+        m_areaSelection = (event->modifiers() & Qt::ControlModifier) ? AreaSelection::Lasso : AreaSelection::Rectangle;
+        m_areaStart = event->pos();
+        m_lassoPoints = QPolygon() << event->pos();
+        m_lastMousePos = event->pos();
+        return;
+    }
+
     if (event->button() == Qt::LeftButton) {
         // Start rotation
         if (!m_view.IsNull()) {
@@ -452,13 +1033,14 @@ void QtOccView::mousePressEvent(QMouseEvent* event) {
 
 	// 处理视图立方体的点击事件
     if (event->button() == Qt::LeftButton && !m_context.IsNull()) {
-        m_context->MoveTo(event->pos().x(), event->pos().y(), m_view, Standard_True);
+        m_context->MoveTo(event->pos().x(), event->pos().y(), m_view, Standard_False);
         if (m_context->HasDetected()) { 
             Handle(AIS_InteractiveObject) detectedObject = m_context->DetectedInteractive();
             // 检查检测到的对象是否是 AIS_ViewCube
             if (!detectedObject.IsNull() && detectedObject->IsKind(STANDARD_TYPE(AIS_ViewCube))) {
                 // 如果是视图立方体，则调用 Select() 方法来触发视角切换          
-                m_context->Select(Standard_True);
+                m_context->Select(Standard_False);
+                RequestRedraw();
                 event->accept();
                 return;
             }
@@ -490,22 +1072,28 @@ void QtOccView::mouseMoveEvent(QMouseEvent* event) {
         return;
     }
     
+    if (m_areaSelection != AreaSelection::None) {
+        UpdateRubberBand(currentPos);
+        m_lastMousePos = currentPos;
+        return;
+    }
+    
     if (m_currentMouseButton == Qt::LeftButton) {
         // Rotate - use absolute position for rotation
         m_view->Rotation(currentPos.x(), currentPos.y());
-        m_view->Redraw();  // 确保实时渲染
+        RequestRedraw();  // 确保实时渲染
     } else if (m_currentMouseButton == Qt::MiddleButton) {
         // Pan - use delta for panning
         QPoint delta = currentPos - m_lastMousePos;
         m_view->Pan(delta.x(), -delta.y());
-        m_view->Redraw();  // 确保实时渲染
+        RequestRedraw();  // 确保实时渲染
     } else if (m_currentMouseButton == Qt::RightButton) {
         // Zoom - use delta for zooming
         QPoint delta = currentPos - m_lastMousePos;
         if (delta.y() != 0) {
             double factor = (delta.y() > 0) ? 0.9 : 1.1;
             m_view->SetZoom(factor);
-            m_view->Redraw();  // 确保实时渲染
+            RequestRedraw();  // 确保实时渲染
         }
     }
     
@@ -520,7 +1108,24 @@ void QtOccView::mouseReleaseEvent(QMouseEvent* event) {
         return;
     }
     
-    Q_UNUSED(event);
+    if (m_areaSelection != AreaSelection::None) {
+        const AreaSelection area = m_areaSelection;
+        m_areaSelection = AreaSelection::None;
+        HideRubberBand();
+        
+        // A drag of a few pixels is treated as a normal click
+        if ((event->pos() - m_areaStart).manhattanLength() < 3) {
+            HandleSelection(event->pos());
+        } else if (area == AreaSelection::Rectangle) {
+            SelectInRectangle(QRect(m_areaStart, event->pos()).normalized());
+        } else {
+            SelectInPolygon(m_lassoPoints);
+        }
+        m_lassoPoints.clear();
+        m_currentMouseButton = Qt::NoButton;
+        return;
+    }
+    
     m_currentMouseButton = Qt::NoButton;
 }
 
@@ -531,7 +1136,7 @@ void QtOccView::wheelEvent(QWheelEvent* event) {
     const double factor = (delta > 0) ? 1.1 : 0.9;
     
     m_view->SetZoom(factor);
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 void QtOccView::keyPressEvent(QKeyEvent* event) {
@@ -562,9 +1167,38 @@ void QtOccView::InitializeOCC() {
 }
 
 void QtOccView::RedrawView() {
-    if (!m_view.IsNull()) {
-        m_view->Redraw();
+    // Goes through the frame scheduler like every other redraw
+    RequestRedraw();
+}
+
+void QtOccView::RequestRedraw() {
+    m_redrawStats.requested++;
+    m_fullRedrawPending = true;
+    ScheduleFrame();
+}
+
+void QtOccView::RequestImmediateRedraw() {
+    m_redrawStats.immediateRequested++;
+    m_immediateRedrawPending = true;
+    ScheduleFrame();
+}
+
+void QtOccView::ScheduleFrame() {
+    if (m_redrawTimer->isActive()) {
+        return; // Already coalesced into the next frame
     }
+    
+    // At most one frame per interval; the first request after a quiet period is served at once
+    qint64 sinceLastFrame = m_frameClock.isValid() ? m_frameClock.elapsed() : kFrameIntervalMs;
+    m_redrawTimer->start(static_cast<int>(std::max<qint64>(0, kFrameIntervalMs - sinceLastFrame)));
+}
+
+QtOccView::RedrawStatistics QtOccView::GetRedrawStatistics() const {
+    return m_redrawStats;
+}
+
+void QtOccView::ResetRedrawStatistics() {
+    m_redrawStats = RedrawStatistics();
 }
 
 void QtOccView::HandleSelection(const QPoint& point) {
@@ -587,14 +1221,14 @@ void QtOccView::HandleSelection(const QPoint& point) {
     }
     
     // Perform selection at click point
-    m_context->MoveTo(point.x(), point.y(), m_view, Standard_True);
+    m_context->MoveTo(point.x(), point.y(), m_view, Standard_False);
     
     if (m_context->HasDetected()) {
         if (m_currentSelectionMode == 2) { // Edge mode
             // Handle edge selection for fillet/chamfer operations
             qDebug() << "Edge selection mode detected, attempting to select edge...";
             
-            m_context->Select(Standard_True);
+            m_context->Select(Standard_False);
             
             // Get selected edges from OpenCASCADE context
             int selectedCount = 0;
@@ -607,13 +1241,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
                 
                 if (!aisShape.IsNull()) {
                     // Find the corresponding cad_core::ShapePtr for this AIS_Shape
-                    cad_core::ShapePtr parentShape = nullptr;
-                    for (const auto& pair : m_shapeToAIS) {
-                        if (pair.second == aisShape) {
-                            parentShape = pair.first;
-                            break;
-                        }
-                    }
+                    cad_core::ShapePtr parentShape = FindShapeForAIS(aisShape);
                     
                     if (!parentShape) {
                         qDebug() << "Could not find parent shape for selected edge";
@@ -629,16 +1257,8 @@ void QtOccView::HandleSelection(const QPoint& point) {
                         if (selectedShape.ShapeType() == TopAbs_EDGE) {
                             TopoDS_Edge edge = TopoDS::Edge(selectedShape);
                             
-                            // Add edge to selection if not already selected
-                            bool alreadySelected = false;
-                            for (const auto& existingEdge : m_selectedEdges) {
-                                if (edge.IsSame(existingEdge)) {
-                                    alreadySelected = true;
-                                    break;
-                                }
-                            }
-                            
-                            if (!alreadySelected) {
+                            // Add edge to selection if not already selected (the set ignores orientation, like IsSame)
+                            if (m_selectedEdgeSet.Add(edge)) {
                                 m_selectedEdges.push_back(edge);
                                 m_edgeParentShapes.push_back(parentShape);  // Track parent shape for this edge
                                 qDebug() << "Added edge to selection, total edges:" << m_selectedEdges.size() 
@@ -663,7 +1283,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
             // Handle vertex selection
             qDebug() << "Vertex selection mode detected, attempting to select vertex...";
             
-            m_context->Select(Standard_True);
+            m_context->Select(Standard_False);
             
             // Get selected vertex from OpenCASCADE context
             for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
@@ -693,7 +1313,7 @@ void QtOccView::HandleSelection(const QPoint& point) {
             // Handle face selection for sketch mode
             qDebug() << "Face selection mode detected, attempting to select face...";
             
-            m_context->Select(Standard_True);
+            m_context->Select(Standard_False);
             
             // Get selected face from OpenCASCADE context
             for (m_context->InitSelected(); m_context->MoreSelected(); m_context->NextSelected()) {
@@ -734,18 +1354,12 @@ void QtOccView::HandleSelection(const QPoint& point) {
                 }
                 
                 // Find the corresponding shape
-                cad_core::ShapePtr foundShape;
-                for (const auto& pair : m_shapeToAIS) {
-                    if (pair.second == aisShape) {
-                        foundShape = pair.first;
-                        break;
-                    }
-                }
+                cad_core::ShapePtr foundShape = FindShapeForAIS(aisShape);
                 
                 if (foundShape) {
                     // Set new selection with highlighting
-                    m_context->SetSelected(aisShape, Standard_True);
-                    m_context->HilightSelected(Standard_True);
+                    m_context->SetSelected(aisShape, Standard_False);
+                    m_context->HilightSelected(Standard_False);
                     m_currentSelectedAIS = aisShape;
                     m_currentSelectedShape = foundShape;
                     
@@ -775,12 +1389,30 @@ void QtOccView::HandleSelection(const QPoint& point) {
     }
     
     // Force redraw to show selection highlighting
-    m_view->Redraw();
+    RequestRedraw();
     emit ViewChanged();
 }
 
 void QtOccView::OnRedrawTimer() {
-    RedrawView();
+    if (m_view.IsNull()) {
+        return;
+    }
+    
+    // Highlight sets changed since the last frame are rebuilt once here
+    FlushHighlights();
+    
+    // A full redraw also refreshes the immediate layers
+    if (m_fullRedrawPending) {
+        m_view->Redraw();
+        m_redrawStats.executed++;
+    } else if (m_immediateRedrawPending) {
+        m_view->RedrawImmediate();
+        m_redrawStats.immediateExecuted++;
+    }
+    
+    m_fullRedrawPending = false;
+    m_immediateRedrawPending = false;
+    m_frameClock.restart();
 }
 
 // 选择模式设置
@@ -863,7 +1495,7 @@ void QtOccView::showEvent(QShowEvent* event) {
     // Minimal redraw when widget is shown - only if necessary
     if (!m_view.IsNull()) {
         m_view->MustBeResized();
-        m_view->Redraw();
+        RequestRedraw();
     }
 }
 
@@ -878,8 +1510,7 @@ void QtOccView::changeEvent(QEvent* event) {
         
         if (!m_view.IsNull() && !m_context.IsNull()) {
             // Force maintain viewer state regardless of activation
-            m_context->UpdateCurrentViewer();
-            m_view->Redraw();
+            RequestRedraw();
         }
     }
 }
@@ -903,13 +1534,13 @@ void QtOccView::SelectShape(const cad_core::ShapePtr& shape) {
         Handle(AIS_Shape) aisShape = it->second;
         if (!aisShape.IsNull()) {
             // Set new selection with highlighting
-            m_context->SetSelected(aisShape, Standard_True);
-            m_context->HilightSelected(Standard_True);
+            m_context->SetSelected(aisShape, Standard_False);
+            m_context->HilightSelected(Standard_False);
             m_currentSelectedAIS = aisShape;
             m_currentSelectedShape = shape;
             
             // Redraw to show selection
-            m_view->Redraw();
+            RequestRedraw();
         }
     }
 }
@@ -923,10 +1554,10 @@ void QtOccView::ClearEdgeSelection() {
     
     // Clear edge lists and parent shape tracking
     m_selectedEdges.clear();
-    m_highlightedEdges.clear();
+    m_selectedEdgeSet.Clear();
     m_edgeParentShapes.clear();
     
-    m_view->Redraw();
+    RequestRedraw();
 }
 
 std::map<cad_core::ShapePtr, std::vector<TopoDS_Edge>> QtOccView::GetSelectedEdgesByShape() const {
@@ -945,123 +1576,257 @@ std::map<cad_core::ShapePtr, std::vector<TopoDS_Edge>> QtOccView::GetSelectedEdg
     return result;
 }
 
+int QtOccView::AddEdgesToSelection(const cad_core::ShapePtr& shape, const std::vector<TopoDS_Edge>& edges) {
+    if (!shape || m_context.IsNull()) return 0;
+    
+    // Same bookkeeping as an edge click, highlighted through one overlay rebuild
+    int added = 0;
+    for (const auto& edge : edges) {
+        if (m_selectedEdgeSet.Add(edge)) {
+            m_selectedEdges.push_back(edge);
+            m_edgeParentShapes.push_back(shape);
+            AddHighlight(m_edgeHighlight, edge);
+            ++added;
+        }
+    }
+    
+    return added;
+}
+
 void QtOccView::HighlightEdge(const TopoDS_Edge& edge) {
     if (m_context.IsNull()) return;
     
-    // Create AIS object for edge highlighting
-    Handle(AIS_Shape) aisEdge = new AIS_Shape(edge);
+    // Added to the merged edge overlay, which is rebuilt once before the next frame
+    AddHighlight(m_edgeHighlight, edge);
+}
+
+void QtOccView::UnhighlightAllEdges() {
+    if (m_context.IsNull()) return;
     
-    // Set edge highlighting properties - make it thicker and colored
-    Handle(Prs3d_Drawer) drawer = aisEdge->Attributes();
-    drawer->SetLineAspect(new Prs3d_LineAspect(Quantity_NOC_RED, Aspect_TOL_SOLID, 3.0));
-    drawer->SetWireAspect(new Prs3d_LineAspect(Quantity_NOC_RED, Aspect_TOL_SOLID, 3.0));
+    ClearHighlight(m_edgeHighlight);
+}
+
+void QtOccView::HighlightVertex(const TopoDS_Vertex& vertex) {
+    if (m_context.IsNull()) return;
     
-    // Display the highlighted edge
-    m_context->Display(aisEdge, Standard_False);
-    m_highlightedEdges.push_back(aisEdge);
+    // 加入合并的点高亮层（同时作为选中点集合）
+    if (AddHighlight(m_vertexHighlight, vertex)) {
+        qDebug() << "Added vertex to selection, total vertices:" << m_vertexHighlight.shapes.Extent();
+    }
+}
+
+void QtOccView::UnhighlightAllVertices() {
+    if (m_context.IsNull()) return;
     
-    m_view->Redraw();
+    ClearHighlight(m_vertexHighlight);
 }
 
-void QtOccView::UnhighlightAllEdges() {
+void QtOccView::HighlightFace(const TopoDS_Face& face) {
     if (m_context.IsNull()) return;
     
-    // Remove all highlighted edges from display
-    for (const auto& highlightedEdge : m_highlightedEdges) {
-        m_context->Remove(highlightedEdge, Standard_False);
+    // 加入合并的面高亮层（同时作为选中面集合）
+    if (AddHighlight(m_faceHighlight, face)) {
+        qDebug() << "Added face to selection, total faces:" << m_faceHighlight.shapes.Extent();
     }
-    
-    m_highlightedEdges.clear();
-    m_view->Redraw();
 }
 
-void QtOccView::HighlightVertex(const TopoDS_Vertex& vertex) {
+void QtOccView::UnhighlightAllFaces() {
     if (m_context.IsNull()) return;
     
-    // 使用临时AIS对象显示高亮的点
-    Handle(AIS_Shape) aisVertex = new AIS_Shape(vertex);
+    ClearHighlight(m_faceHighlight);
+}
+
+int QtOccView::SelectInRectangle(const QRect& rect) {
+    if (m_context.IsNull() || m_view.IsNull() || rect.isEmpty()) return 0;
     
-    // 设置点的高亮属性 - 红色球形
-    aisVertex->SetColor(Quantity_NOC_RED);
-    aisVertex->SetWidth(5.0);
+    // Edges accumulate like single edge clicks; other modes replace the previous selection
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<cad_core::SelectionInfo> picked = m_selectionManager->SelectInRectangle(
+        rect.left(), rect.top(), rect.right(), rect.bottom(), m_currentSelectionMode == 2);
+    const qint64 pickTime = timer.elapsed();
     
-    // 显示高亮的点
-    m_context->Display(aisVertex, Standard_False);
+    int committed = CommitAreaSelection(picked);
+    qDebug() << "Box selection picked" << picked.size() << "entities in" << pickTime
+             << "ms, committed" << committed << "in" << timer.elapsed() - pickTime << "ms";
+    return committed;
+}
+
+int QtOccView::SelectInPolygon(const QPolygon& polygon) {
+    if (m_context.IsNull() || m_view.IsNull() || polygon.size() < 3) return 0;
     
-    // 添加到选中点列表
-    bool alreadySelected = false;
-    for (const auto& existingVertex : m_selectedVertices) {
-        if (vertex.IsSame(existingVertex)) {
-            alreadySelected = true;
-            break;
-        }
+    std::vector<std::pair<int, int>> points;
+    points.reserve(polygon.size());
+    for (const QPoint& point : polygon) {
+        points.emplace_back(point.x(), point.y());
     }
     
-    if (!alreadySelected) {
-        m_selectedVertices.push_back(vertex);
-        m_highlightedVertices.push_back(aisVertex);
-        qDebug() << "Added vertex to selection, total vertices:" << m_selectedVertices.size();
-    }
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<cad_core::SelectionInfo> picked = m_selectionManager->SelectInPolygon(points, m_currentSelectionMode == 2);
+    const qint64 pickTime = timer.elapsed();
     
-    m_view->Redraw();
+    int committed = CommitAreaSelection(picked);
+    qDebug() << "Lasso selection picked" << picked.size() << "entities in" << pickTime
+             << "ms, committed" << committed << "in" << timer.elapsed() - pickTime << "ms";
+    return committed;
 }
 
-void QtOccView::UnhighlightAllVertices() {
-    if (m_context.IsNull()) return;
+int QtOccView::CommitAreaSelection(const std::vector<cad_core::SelectionInfo>& picked) {
+    int committed = 0;
     
-    // Remove all highlighted vertices from display
-    for (const auto& highlightedVertex : m_highlightedVertices) {
-        m_context->Remove(highlightedVertex, Standard_False);
+    // Everything goes into the merged overlays; they are rebuilt once on the next frame
+    switch (m_currentSelectionMode) {
+        case 2: // Edge
+            for (const auto& info : picked) {
+                if (info.shapeType != TopAbs_EDGE || !info.shape) continue;
+                const TopoDS_Edge& edge = TopoDS::Edge(info.subShape);
+                if (m_selectedEdgeSet.Add(edge)) {
+                    m_selectedEdges.push_back(edge);
+                    m_edgeParentShapes.push_back(info.shape);
+                    AddHighlight(m_edgeHighlight, edge);
+                    ++committed;
+                }
+            }
+            break;
+        case 1: // Vertex
+            UnhighlightAllVertices();
+            for (const auto& info : picked) {
+                if (info.shapeType == TopAbs_VERTEX && AddHighlight(m_vertexHighlight, info.subShape)) {
+                    ++committed;
+                }
+            }
+            break;
+        case 4: // Face
+            UnhighlightAllFaces();
+            for (const auto& info : picked) {
+                if (info.shapeType == TopAbs_FACE && AddHighlight(m_faceHighlight, info.subShape)) {
+                    ++committed;
+                }
+            }
+            break;
+        default: { // Shape
+            if (!m_currentSelectedAIS.IsNull()) {
+                m_currentSelectedAIS.Nullify();
+                m_currentSelectedShape.reset();
+            }
+            m_context->ClearSelected(Standard_False);
+            for (const auto& info : picked) {
+                auto it = m_shapeToAIS.find(info.shape);
+                if (it == m_shapeToAIS.end() || it->second.IsNull()) continue;
+                m_context->AddSelect(it->second);
+                if (m_currentSelectedAIS.IsNull()) {
+                    m_currentSelectedAIS = it->second;
+                    m_currentSelectedShape = info.shape;
+                }
+                ++committed;
+            }
+            m_context->HilightSelected(Standard_False);
+            if (m_currentSelectedShape) {
+                emit ShapeSelected(m_currentSelectedShape);
+            }
+            RequestRedraw();
+            break;
+        }
     }
     
-    m_highlightedVertices.clear();
-    m_selectedVertices.clear();
-    m_view->Redraw();
+    RequestImmediateRedraw();
+    emit ViewChanged();
+    return committed;
 }
 
-void QtOccView::HighlightFace(const TopoDS_Face& face) {
-    if (m_context.IsNull()) return;
+void QtOccView::UpdateRubberBand(const QPoint& pos) {
+    if (m_context.IsNull() || m_view.IsNull()) return;
     
-    // 使用临时AIS对象显示高亮的面
-    Handle(AIS_Shape) aisFace = new AIS_Shape(face);
+    if (m_rubberBand.IsNull()) {
+        m_rubberBand = new AIS_RubberBand(Quantity_NOC_LIGHTBLUE, Aspect_TOL_SOLID, Quantity_NOC_LIGHTBLUE, 0.4, 1.0);
+        m_rubberBand->SetZLayer(Graphic3d_ZLayerId_TopOSD);
+        m_rubberBand->SetTransformPersistence(new Graphic3d_TransformPers(Graphic3d_TMF_2d, Aspect_TOTP_LEFT_LOWER));
+        m_rubberBand->SetDisplayMode(0);
+        m_rubberBand->SetMutable(Standard_True);
+    }
     
-    // 设置面的高亮属性 - 半透明红色
-    aisFace->SetColor(Quantity_NOC_RED);
-    aisFace->SetTransparency(0.3); // 半透明
-    aisFace->SetDisplayMode(AIS_Shaded);
+    // The band is drawn in window pixels with a bottom-left origin
+    Standard_Integer width = 0, height = 0;
+    m_view->Window()->Size(width, height);
+    if (m_areaSelection == AreaSelection::Rectangle) {
+        const QRect rect = QRect(m_areaStart, pos).normalized();
+        m_rubberBand->SetRectangle(rect.left(), height - rect.bottom(), rect.right(), height - rect.top());
+    } else {
+        if ((pos - m_lassoPoints.last()).manhattanLength() >= 3) {
+            m_lassoPoints << pos;
+        }
+        m_rubberBand->ClearPoints();
+        for (const QPoint& point : m_lassoPoints) {
+            m_rubberBand->AddPoint(Graphic3d_Vec2i(point.x(), height - point.y()));
+        }
+    }
     
-    // 显示高亮的面
-    m_context->Display(aisFace, Standard_False);
+    if (m_context->IsDisplayed(m_rubberBand)) {
+        m_context->Redisplay(m_rubberBand, Standard_False);
+    } else {
+        m_context->Display(m_rubberBand, 0, -1, Standard_False);
+    }
+    RequestImmediateRedraw();
+}
+
+void QtOccView::HideRubberBand() {
+    if (m_context.IsNull() || m_rubberBand.IsNull()) return;
     
-    // 添加到选中面列表
-    bool alreadySelected = false;
-    for (const auto& existingFace : m_selectedFaces) {
-        if (face.IsSame(existingFace)) {
-            alreadySelected = true;
-            break;
-        }
+    m_context->Remove(m_rubberBand, Standard_False);
+    RequestImmediateRedraw();
+}
+
+bool QtOccView::AddHighlight(HighlightOverlay& overlay, const TopoDS_Shape& shape) {
+    const int before = overlay.shapes.Extent();
+    overlay.shapes.Add(shape);
+    if (overlay.shapes.Extent() == before) {
+        return false;  // already highlighted (IsSame)
     }
     
-    if (!alreadySelected) {
-        m_selectedFaces.push_back(face);
-        m_highlightedFaces.push_back(aisFace);
-        qDebug() << "Added face to selection, total faces:" << m_selectedFaces.size();
+    overlay.dirty = true;
+    RequestImmediateRedraw();
+    return true;
+}
+
+void QtOccView::ClearHighlight(HighlightOverlay& overlay) {
+    if (overlay.shapes.IsEmpty() && !overlay.dirty) {
+        return;
     }
     
-    m_view->Redraw();
+    // One overlay object to refresh regardless of how many sub-shapes were highlighted
+    overlay.shapes.Clear();
+    overlay.dirty = true;
+    RequestImmediateRedraw();
 }
 
-void QtOccView::UnhighlightAllFaces() {
-    if (m_context.IsNull()) return;
+void QtOccView::RebuildHighlight(HighlightOverlay& overlay) {
+    overlay.dirty = false;
+    if (m_context.IsNull() || overlay.aisShape.IsNull()) {
+        return;
+    }
     
-    // Remove all highlighted faces from display
-    for (const auto& highlightedFace : m_highlightedFaces) {
-        m_context->Remove(highlightedFace, Standard_False);
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    for (int i = 1; i <= overlay.shapes.Extent(); ++i) {
+        builder.Add(compound, overlay.shapes(i));
     }
+    overlay.aisShape->SetShape(compound);
     
-    m_highlightedFaces.clear();
-    m_selectedFaces.clear();
-    m_view->Redraw();
+    // Overlays are never selectable, so they are displayed without any selection mode
+    if (m_context->IsDisplayed(overlay.aisShape)) {
+        m_context->Redisplay(overlay.aisShape, Standard_False);
+    } else {
+        overlay.aisShape->SetToUpdate();
+        m_context->Display(overlay.aisShape, overlay.aisShape->DisplayMode(), -1, Standard_False);
+    }
+}
+
+void QtOccView::FlushHighlights() {
+    if (m_edgeHighlight.dirty) RebuildHighlight(m_edgeHighlight);
+    if (m_vertexHighlight.dirty) RebuildHighlight(m_vertexHighlight);
+    if (m_faceHighlight.dirty) RebuildHighlight(m_faceHighlight);
 }
 
 // =============================================================================
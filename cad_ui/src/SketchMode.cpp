@@ -667,7 +667,7 @@ void SketchMode::SetupSketchView() {
         view->ZFitAll();
 
         // 强制重绘
-        view->Redraw();
+        m_viewer->RequestRedraw();
 
         qDebug() << "Setup sketch view completed:";
         qDebug() << "  Eye:" << eyePosition.X() << eyePosition.Y() << eyePosition.Z();
@@ -779,7 +779,7 @@ void SketchMode::ClearPreviewDisplay() {
     m_previewElements.clear();
 
     // 通知查看器内容已更新
-    m_viewer->GetContext()->UpdateCurrentViewer();
+    m_viewer->RequestRedraw();
 }
 
 // 更新预览图形
@@ -804,7 +804,7 @@ void SketchMode::UpdatePreview(const std::vector<cad_sketch::SketchLinePtr>& pre
     }
 
     // 在所有对象都添加完毕后，手动触发一次重绘
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 // 显示最终的草图元素
@@ -834,7 +834,7 @@ void SketchMode::DisplaySketchElement(const cad_sketch::SketchElementPtr& elemen
     m_viewer->GetContext()->Display(aisShape, Standard_False);
 
     // 使用正确的刷新方式
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 // 清除所有草图显示（退出时使用）
@@ -845,7 +845,7 @@ void SketchMode::ClearAllSketchDisplay() {
         m_viewer->GetContext()->Remove(val, Standard_False);
     }
     m_displayedElements.clear();
-    m_viewer->GetView()->Redraw();
+    m_viewer->RequestRedraw();
 }
 
 } // namespace cad_ui